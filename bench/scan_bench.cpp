@@ -0,0 +1,270 @@
+// frogkill-bench: per-tick cost of the sampling pipeline, against the live
+// /proc or a synthetic procfs tree of any size.
+//
+//   frogkill-bench [--iterations N] [--max-threads N] [--events] [--filter QUERY]
+//                  [--procs N [--depth N] [--cmdline-len N] [--churn PERCENT] [--dir PATH]]
+//
+// First ProcSampler::sample() is timed for 1, 2, 4 ... --max-threads scan
+// threads. Then every stage of a GUI tick runs in sequence (serial scan)
+// and gets latency percentiles, heap allocations per tick and the RSS it
+// added over the run; the first tick (cold caches, model reset) is left out.
+//
+// The recording stage (SnapshotWriter::append) writes a scratch file under
+// --dir, removed at the end.
+//
+// --procs generates a synthetic tree with that many processes under --dir
+// (default /tmp) and samples it instead of /proc; each tick --churn percent
+// of them (default 5) burn CPU. --events samples in proc connector mode
+// (live /proc only; needs CAP_NET_ADMIN).
+
+#include "../src/proc_filter.h"
+#include "../src/proc_history.h"
+#include "../src/process_model.h"
+#include "../src/process_tree_model.h"
+#include "../src/procfs.h"
+#include "../src/snapshot.h"
+#include "../src/snapshot_file.h"
+#include "../src/system_sampler.h"
+#include "../src/util.h"
+#include "synthetic_procfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Heap allocations, counted by interposing glibc's malloc family (Qt's
+// containers bypass operator new, so that alone would miss them).
+static std::atomic<unsigned long long> g_allocs{0};
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+
+void* malloc(size_t n) noexcept {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(n);
+}
+void* calloc(size_t n, size_t size) noexcept {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+void* realloc(void* p, size_t n) noexcept {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, n);
+}
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t idx = std::min(v.size() - 1, (size_t)(p * (double)(v.size() - 1) + 0.5));
+    return v[idx];
+}
+
+// Resident set of this process, in KiB (read from the real /proc).
+static long long selfRssKib() {
+    static FrogKill::ProcDir dir;
+    static FrogKill::ProcReader reader(dir);
+    if (!dir.isOpen()) dir.open("/proc");
+    long long pages = 0;
+    reader.readRssPages((int)::getpid(), pages);
+    return pages * (::sysconf(_SC_PAGESIZE) / 1024);
+}
+
+struct Stage {
+    const char* name;
+    std::function<void(FrogKill::Snapshot&)> run;
+    std::vector<double> ms;
+    unsigned long long allocs{0};
+    long long rssGrowthKib{0};
+};
+
+int main(int argc, char** argv) {
+    int iterations = 30;
+    int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    bool events = false;
+    std::string query = "python";
+    SyntheticProcfsOptions synthetic;
+    bool useSynthetic = false;
+    double churn = 5.0;
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--events") == 0) {
+            events = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            query = argv[++i];
+        } else if (std::strcmp(argv[i], "--procs") == 0 && i + 1 < argc) {
+            synthetic.procs = (size_t)std::max(1, std::atoi(argv[++i]));
+            useSynthetic = true;
+        } else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            synthetic.depth = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--cmdline-len") == 0 && i + 1 < argc) {
+            synthetic.cmdlineLen = (size_t)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--churn") == 0 && i + 1 < argc) {
+            churn = std::clamp(std::atof(argv[++i]), 0.0, 100.0);
+        } else if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: frogkill-bench [--iterations N] [--max-threads N] [--events] [--filter QUERY]\n"
+                                 "                      [--procs N [--depth N] [--cmdline-len N] [--churn PERCENT] [--dir PATH]]\n");
+            return 2;
+        }
+    }
+
+    std::unique_ptr<SyntheticProcfs> fake;
+    std::string root = "/proc";
+    if (useSynthetic) {
+        if (events) {
+            std::fprintf(stderr, "--events needs the live /proc\n");
+            return 2;
+        }
+        fake = std::make_unique<SyntheticProcfs>(synthetic);
+        const auto t0 = Clock::now();
+        if (!fake->create(dir.c_str())) {
+            std::fprintf(stderr, "cannot create a synthetic procfs under %s\n", dir.c_str());
+            return 1;
+        }
+        root = fake->root();
+        std::printf("synthetic procfs: %zu processes, depth %d, %zu-byte cmdlines, %.0f%% churn (%s, %.1f s)\n\n",
+                    synthetic.procs, synthetic.depth, synthetic.cmdlineLen, churn, root.c_str(),
+                    std::chrono::duration<double>(Clock::now() - t0).count());
+    }
+    auto advance = [&] {
+        if (fake && !fake->advance(churn / 100.0)) {
+            std::fprintf(stderr, "cannot update the synthetic procfs\n");
+            std::exit(1);
+        }
+    };
+
+    std::printf("%-8s %8s %10s %10s %10s %10s\n", "threads", "procs", "median_ms", "p95_ms", "speedup",
+                "meta/tick");
+    // 1, 2, 4, ... and finally maxThreads itself.
+    std::vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    double baseline = 0.0;
+    for (const int threads : counts) {
+        FrogKill::ProcSampler sampler(root.c_str());
+        FrogKill::ProcTable table;
+        sampler.setThreads(threads);
+        if (events && !sampler.setEventDriven(true)) {
+            std::fprintf(stderr, "proc connector unavailable (needs CAP_NET_ADMIN)\n");
+            return 1;
+        }
+        sampler.sample(table); // warm-up (CPU baseline, caches)
+        size_t procs = table.size();
+        size_t metadataReads = 0;
+
+        std::vector<double> ms;
+        ms.reserve((size_t)iterations);
+        for (int it = 0; it < iterations; ++it) {
+            advance();
+            const auto t0 = Clock::now();
+            sampler.sample(table);
+            procs = table.size();
+            metadataReads += sampler.lastMetadataReads();
+            ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+
+        const double median = percentile(ms, 0.5);
+        if (threads == 1) baseline = median;
+        std::printf("%-8d %8zu %10.3f %10.3f %9.2fx %10.1f\n", threads, procs, median, percentile(ms, 0.95),
+                    median > 0.0 ? baseline / median : 0.0, (double)metadataReads / iterations);
+    }
+
+    // One GUI tick, stage by stage. Two snapshots alternate as in
+    // SnapshotSlot: the models still read the previous one while the next
+    // is filled.
+    FrogKill::ProcSampler sampler(root.c_str());
+    if (events) sampler.setEventDriven(true);
+    FrogKill::SystemSampler sys(root.c_str());
+    FrogKill::ProcFilter filter;
+    filter.setQuery(query);
+    FrogKill::ProcessModel model;
+    model.sort(2, Qt::DescendingOrder);   // CPU, as the table opens
+    FrogKill::ProcessTreeModel treeModel;
+    FrogKill::ProcHistory history;
+    history.configure(8u << 20, 60);   // the GUI's default
+    FrogKill::Snapshot snaps[2];
+    unsigned long long seq = 0;
+    FrogKill::SnapshotWriter recorder;
+    const std::string recordPath = dir + "/frogkill-bench-" + std::to_string(::getpid()) + ".rec";
+    if (!recorder.open(recordPath.c_str())) {
+        std::fprintf(stderr, "cannot create %s\n", recordPath.c_str());
+        return 1;
+    }
+
+    Stage stages[] = {
+        {"ProcSampler::sample", [&](FrogKill::Snapshot& s) { sampler.sample(s.procs); }, {}},
+        {"SystemSampler::sample", [&](FrogKill::Snapshot& s) { s.sys = sys.sample(); }, {}},
+        {"ProcIndex::build", [&](FrogKill::Snapshot& s) { s.tree.build(s.procs); }, {}},
+        {"ProcFilter::apply", [&](FrogKill::Snapshot& s) { filter.apply(s.procs, s.seq); }, {}},
+        {"ProcHistory::update", [&](FrogKill::Snapshot& s) { history.update(s.procs); }, {}},
+        {"ProcessModel refresh", [&](FrogKill::Snapshot& s) { model.setSnapshot(&s); }, {}},
+        {"ProcessTreeModel refresh", [&](FrogKill::Snapshot& s) { treeModel.setSnapshot(&s); }, {}},
+        {"SnapshotWriter::append",
+         [&](FrogKill::Snapshot& s) { recorder.append(s.procs, s.sys, s.seq, (long long)s.seq * 1000); }, {}},
+    };
+
+    size_t matches = 0;
+    for (int it = 0; it <= iterations; ++it) {
+        advance();
+        FrogKill::Snapshot& s = snaps[it & 1];
+        s.seq = ++seq;
+        for (Stage& stage : stages) {
+            const long long rss0 = selfRssKib();
+            const unsigned long long allocs0 = g_allocs.load(std::memory_order_relaxed);
+            const auto t0 = Clock::now();
+            stage.run(s);
+            const auto t1 = Clock::now();
+            if (it == 0) continue;
+            stage.allocs += g_allocs.load(std::memory_order_relaxed) - allocs0;
+            stage.ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            stage.rssGrowthKib += selfRssKib() - rss0;
+        }
+        matches = filter.matchCount();
+    }
+
+    std::printf("\n%zu processes, filter \"%s\" matches %zu\n", snaps[iterations & 1].procs.size(), query.c_str(),
+                matches);
+    std::printf("%-26s %9s %9s %9s %9s %12s %12s\n", "stage", "p50_ms", "p95_ms", "p99_ms", "max_ms", "allocs/tick",
+                "rss_grow_kib");
+    for (const Stage& stage : stages) {
+        std::printf("%-26s %9.3f %9.3f %9.3f %9.3f %12.1f %12lld\n", stage.name, percentile(stage.ms, 0.5),
+                    percentile(stage.ms, 0.95), percentile(stage.ms, 0.99), percentile(stage.ms, 1.0),
+                    (double)stage.allocs / iterations, stage.rssGrowthKib);
+    }
+    std::printf("rss %.1f MiB\n", (double)selfRssKib() / 1024.0);
+
+    // Frame 0 is a keyframe; the rest are deltas.
+    const unsigned long long recorded = recorder.bytesWritten();
+    recorder.close();
+    ::unlink(recordPath.c_str());
+    const size_t procs = std::max<size_t>(1, snaps[iterations & 1].procs.size());
+    std::printf("recording: %llu bytes for %zu frames, %.2f bytes/process/frame\n", recorded, recorder.frames(),
+                (double)recorded / (double)std::max<size_t>(1, recorder.frames()) / (double)procs);
+
+    const auto users = FrogKill::Util::userCacheStats();
+    std::printf("\nuser cache: %llu hits, %llu NSS lookups, %llu negative hits, %llu invalidations\n",
+                users.hits, users.misses, users.negativeHits, users.invalidations);
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "synthetic_procfs.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr const char* kWords[] = {
+    "firefox", "postgres", "java", "python3", "bash", "sshd", "nginx", "node",
+    "systemd", "chrome", "dockerd", "redis-server", "gnome-shell", "code", "rustc", "make",
+};
+static constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+static constexpr unsigned kUids[] = {0, 0, 1000, 1000, 1000, 33, 70, 999};
+static constexpr long long kHz = 100;   // USER_HZ
+
+static const char* wordOf(int pid) {
+    return kWords[(size_t)pid % kWordCount];
+}
+
+SyntheticProcfs::~SyntheticProcfs() {
+    if (m_root.empty()) return;
+    std::error_code ec;
+    std::filesystem::remove_all(m_root, ec);
+}
+
+bool SyntheticProcfs::writeFile(const std::string& path, const char* data, size_t len) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = ::write(fd, data, len) == (ssize_t)len;
+    ::close(fd);
+    return ok;
+}
+
+bool SyntheticProcfs::writeStat(int pid) {
+    const Proc& p = m_procs[(size_t)pid - 1];
+    char buf[512];
+    // Fields 1..24; starttime (22) is the PID so generations stay stable.
+    const int n = std::snprintf(buf, sizeof(buf),
+        "%d (%s) S %d %d %d 0 -1 4194560 100 0 0 0 %lld %lld 0 0 20 0 1 0 %d %lld %lld\n",
+        pid, wordOf(pid), p.ppid, pid, pid, p.utime, p.utime / 4, pid, p.rssPages * 16384, p.rssPages);
+    if (!writeFile(m_root + "/" + std::to_string(pid) + "/stat", buf, (size_t)n)) return false;
+    const int m = std::snprintf(buf, sizeof(buf), "%lld %lld %lld 1 0 %lld 0\n",
+                                p.rssPages * 4, p.rssPages, p.rssPages / 4, p.rssPages);
+    return writeFile(m_root + "/" + std::to_string(pid) + "/statm", buf, (size_t)m);
+}
+
+bool SyntheticProcfs::writeSystemStat() {
+    // ProcSampler sums the whole cpu line; SystemSampler takes idle apart.
+    char buf[256];
+    const int n = std::snprintf(buf, sizeof(buf), "cpu  %llu 0 %llu %llu 0 0 0 0 0 0\ncpu0 0 0 0 0 0 0 0 0 0 0\n",
+                                m_busy * 3 / 4, m_busy - m_busy * 3 / 4, m_idle);
+    return writeFile(m_root + "/stat", buf, (size_t)n);
+}
+
+bool SyntheticProcfs::create(const char* parentDir) {
+    std::string tmpl = std::string(parentDir) + "/frogkill-procfs-XXXXXX";
+    if (!::mkdtemp(tmpl.data())) return false;
+    m_root = tmpl;
+
+    static constexpr char kMeminfo[] =
+        "MemTotal:       65536000 kB\nMemFree:        20000000 kB\nMemAvailable:   40000000 kB\n"
+        "Buffers:          100000 kB\nCached:         10000000 kB\nSwapCached:            0 kB\n"
+        "SwapTotal:       8388604 kB\nSwapFree:        8000000 kB\n";
+    if (!writeFile(m_root + "/meminfo", kMeminfo, sizeof(kMeminfo) - 1)) return false;
+    if (!writeSystemStat()) return false;
+
+    // Parents always come from the level above, so depth is bounded and
+    // every PID has a parent with a smaller PID.
+    const int depth = std::max(1, m_opt.depth);
+    std::vector<std::vector<int>> levels((size_t)depth);
+    m_procs.assign(m_opt.procs, Proc{});
+    std::string cmdline;
+    char buf[512];
+    size_t deepest = 0;
+    for (int pid = 1; pid <= (int)m_opt.procs; ++pid) {
+        Proc& p = m_procs[(size_t)pid - 1];
+        size_t level = 0;
+        if (pid > 1 && depth > 1) {
+            // Any level down to one below the deepest populated so far.
+            level = 1 + m_rng() % std::min(deepest + 1, levels.size() - 1);
+            const auto& above = levels[level - 1];
+            p.ppid = above[m_rng() % above.size()];
+        }
+        deepest = std::max(deepest, level);
+        levels[level].push_back(pid);
+        p.uid = kUids[m_rng() % (sizeof(kUids) / sizeof(kUids[0]))];
+        p.utime = (long long)(m_rng() % 10000);
+        p.rssPages = 256 + (long long)(m_rng() % 65536);
+
+        const std::string dir = m_root + "/" + std::to_string(pid);
+        if (::mkdir(dir.c_str(), 0755) != 0) return false;
+        if (!writeStat(pid)) return false;
+
+        const int n = std::snprintf(buf, sizeof(buf),
+            "Name:\t%s\nUmask:\t0022\nState:\tS (sleeping)\nTgid:\t%d\nNgid:\t0\nPid:\t%d\nPPid:\t%d\n"
+            "TracerPid:\t0\nUid:\t%u\t%u\t%u\t%u\nGid:\t%u\t%u\t%u\t%u\n",
+            wordOf(pid), pid, pid, p.ppid, p.uid, p.uid, p.uid, p.uid, p.uid, p.uid, p.uid, p.uid);
+        if (!writeFile(dir + "/status", buf, (size_t)n)) return false;
+
+        // "/usr/bin/<word> --id=<pid> xxxx xxxx ...", NUL-separated.
+        cmdline.assign("/usr/bin/");
+        cmdline.append(wordOf(pid));
+        cmdline.push_back('\0');
+        cmdline.append("--id=" + std::to_string(pid));
+        while (cmdline.size() < m_opt.cmdlineLen) {
+            cmdline.push_back('\0');
+            cmdline.append(std::min<size_t>(15, m_opt.cmdlineLen - cmdline.size() + 1), 'x');
+        }
+        cmdline.resize(std::max(m_opt.cmdlineLen, (size_t)1));
+        cmdline.push_back('\0');
+        if (!writeFile(dir + "/cmdline", cmdline.data(), cmdline.size())) return false;
+    }
+    return true;
+}
+
+bool SyntheticProcfs::advance(double fraction) {
+    const long long cores = std::max(1L, ::sysconf(_SC_NPROCESSORS_ONLN));
+    const size_t n = m_procs.size();
+    const size_t busy = std::min(n, (size_t)((double)n * std::clamp(fraction, 0.0, 1.0)));
+    long long burned = 0;
+    for (size_t k = 0; k < busy; ++k) {
+        const int pid = 1 + (int)(m_rng() % n);
+        Proc& p = m_procs[(size_t)pid - 1];
+        const long long d = 1 + (long long)(m_rng() % kHz);
+        p.utime += d;
+        burned += d + d / 4;
+        p.rssPages = std::max(64LL, p.rssPages + (long long)(m_rng() % 512) - 256);
+        if (!writeStat(pid)) return false;
+    }
+    const long long total = cores * kHz;
+    const long long used = std::min(total, burned);
+    m_busy += (unsigned long long)used;
+    m_idle += (unsigned long long)(total - used);
+    return writeSystemStat();
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+// A directory laid out like /proc, for benchmarking the samplers at process
+// counts the machine does not have: top-level stat and meminfo, and per
+// process the stat, statm, status and cmdline files ProcSampler reads.
+//
+// PIDs are 1..procs. Process 1 is the root; every other one hangs below a
+// random process of the level above, for at most `depth` levels.
+struct SyntheticProcfsOptions {
+    size_t procs{10000};
+    int depth{8};
+    size_t cmdlineLen{64};      // bytes of each NUL-separated cmdline
+    unsigned seed{1};
+};
+
+class SyntheticProcfs {
+public:
+    explicit SyntheticProcfs(const SyntheticProcfsOptions& options) : m_opt(options), m_rng(options.seed) {}
+    // Removes the tree.
+    ~SyntheticProcfs();
+    SyntheticProcfs(const SyntheticProcfs&) = delete;
+    SyntheticProcfs& operator=(const SyntheticProcfs&) = delete;
+
+    // Creates the tree in a fresh directory below `parentDir`.
+    bool create(const char* parentDir);
+    const std::string& root() const { return m_root; }
+
+    // One interval of activity: `fraction` of the processes (picked at
+    // random) burn CPU, and the system totals advance by one second.
+    bool advance(double fraction);
+
+private:
+    struct Proc {
+        int ppid;
+        unsigned uid;
+        long long utime;
+        long long rssPages;
+    };
+
+    bool writeFile(const std::string& path, const char* data, size_t len);
+    bool writeStat(int pid);
+    bool writeSystemStat();
+
+    SyntheticProcfsOptions m_opt;
+    std::mt19937 m_rng;
+    std::string m_root;
+    std::vector<Proc> m_procs;          // index = pid - 1
+    unsigned long long m_busy{0};       // system jiffies, for the stat cpu line
+    unsigned long long m_idle{0};
+};
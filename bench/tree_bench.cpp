@@ -0,0 +1,131 @@
+// frogkill-tree-bench: compares the two subtree discovery strategies used by
+// `frogkill-helper --tree` (children files vs. full /proc scan) while the
+// number of processes on the system grows.
+//
+//   frogkill-tree-bench [--sizes N,N,...] [--subtree N] [--iterations N]
+//
+// Filler processes are forked (and killed at exit) to reach each size; the
+// measured tree is a root with --subtree - 1 children.
+
+#include "../src/proc_tree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t idx = std::min(v.size() - 1, (size_t)(p * (double)(v.size() - 1) + 0.5));
+    return v[idx];
+}
+
+// A process that does nothing until killed.
+static int spawnIdle() {
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        for (;;) ::pause();
+    }
+    return (int)pid;
+}
+
+static int countProcs() {
+    std::vector<FrogKill::TreeNode> all;
+    FrogKill::collectSubtreeByScan(1, all);
+    return (int)all.size();
+}
+
+static double timeMs(bool (*collect)(int, std::vector<FrogKill::TreeNode>&), int root, int iterations,
+                     size_t& found) {
+    std::vector<FrogKill::TreeNode> nodes;
+    std::vector<double> ms;
+    ms.reserve((size_t)iterations);
+    for (int it = 0; it < iterations; ++it) {
+        const auto t0 = Clock::now();
+        collect(root, nodes);
+        ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    found = nodes.size();
+    return percentile(ms, 0.5);
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes{0, 1000, 4000};
+    int subtree = 8;
+    int iterations = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes.clear();
+            std::string list = argv[++i];
+            for (size_t pos = 0; pos <= list.size();) {
+                const size_t comma = std::min(list.find(',', pos), list.size());
+                sizes.push_back(std::max(0, std::atoi(list.substr(pos, comma - pos).c_str())));
+                pos = comma + 1;
+            }
+        } else if (std::strcmp(argv[i], "--subtree") == 0 && i + 1 < argc) {
+            subtree = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "usage: frogkill-tree-bench [--sizes N,N,...] [--subtree N] [--iterations N]\n");
+            return 2;
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+
+    // The measured tree: root + (subtree - 1) idle children.
+    const pid_t root = ::fork();
+    if (root == 0) {
+        ::setpgid(0, 0);
+        for (int i = 1; i < subtree; ++i) spawnIdle();
+        for (;;) ::pause();
+    }
+    ::setpgid(root, root);
+
+    std::vector<int> fillers;
+    std::vector<FrogKill::TreeNode> probe;
+    std::printf("%-10s %8s %14s %10s %9s\n", "procs", "subtree", "children_ms", "scan_ms", "speedup");
+    for (const int extra : sizes) {
+        while ((int)fillers.size() < extra) {
+            const int pid = spawnIdle();
+            if (pid < 0) {
+                std::fprintf(stderr, "fork failed after %zu fillers\n", fillers.size());
+                break;
+            }
+            fillers.push_back(pid);
+        }
+        // Let the root finish forking before measuring.
+        for (int tries = 0; tries < 200; ++tries) {
+            FrogKill::collectSubtreeByScan((int)root, probe);
+            if ((int)probe.size() >= subtree) break;
+            ::usleep(10 * 1000);
+        }
+
+        size_t byChildren = 0;
+        size_t byScan = 0;
+        const double childrenMs = timeMs(FrogKill::collectSubtreeByChildren, (int)root, iterations, byChildren);
+        const double scanMs = timeMs(FrogKill::collectSubtreeByScan, (int)root, iterations, byScan);
+        if (byChildren != byScan) {
+            std::fprintf(stderr, "warning: strategies disagree (%zu vs %zu nodes)\n", byChildren, byScan);
+        }
+        std::printf("%-10d %8zu %14.3f %10.3f %8.1fx\n", countProcs(), byScan, childrenMs, scanMs,
+                    childrenMs > 0.0 ? scanMs / childrenMs : 0.0);
+        if ((int)fillers.size() < extra) break;
+    }
+
+    ::kill(-root, SIGKILL);
+    for (const int pid : fillers) ::kill(pid, SIGKILL);
+    while (::waitpid(-1, nullptr, 0) > 0) {}
+    return 0;
+}
@@ -1,19 +1,28 @@
 #include <cerrno>
 #include <csignal>
 #include <cstring>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <filesystem>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <poll.h>
 #include <unistd.h>
 
+#include "../src/helper_protocol.h"
+#include "../src/proc_kill.h"
+#include "../src/tree_kill.h"
+
+using FrogKill::ProcHandle;
+using FrogKill::HelperProto::BatchEntry;
+using FrogKill::HelperProto::Scope;
+
 static void usage() {
-    std::cerr << "frogkill-helper --pid <PID> --sig TERM|KILL [--tree]\n";
+    std::cerr << "frogkill-helper --pid <PID> --sig TERM|KILL [--start-time T] [--grace MS] [--tree | --cgroup]\n"
+                 "frogkill-helper --pids PID[:START],... --sig TERM|KILL [--grace MS]\n"
+                 "frogkill-helper --session [--idle-timeout S]\n";
 }
 
 static bool parseInt(const std::string& s, long long& out) {
@@ -25,10 +34,272 @@ static bool parseInt(const std::string& s, long long& out) {
     return true;
 }
 
+// Performs one validated kill request. Returns the exit status (0 done,
+// 3 refused or gone, 4 failed, 5 still running after the grace period);
+// diagnostics go to `err`.
+static int runKill(int pid, int sig, unsigned long long startTime, int graceMs, Scope scope, std::ostream& err) {
+    if (pid <= 1) {
+        err << "Refusing to signal PID <= 1\n";
+        return 3;
+    }
+
+    // Bind to the generation the caller saw; a reused PID is rejected here.
+    ProcHandle root;
+    const int openErr = root.open(pid, startTime);
+    if (openErr == ESRCH) {
+        err << "PID does not exist (or was reused)\n";
+        return 3;
+    }
+    if (openErr != 0) {
+        err << "pidfd_open(" << pid << ") failed: " << std::strerror(openErr) << "\n";
+        return 4;
+    }
+
+    // --- cgroup mode: the helper resolves the cgroup from the (verified)
+    // PID itself and refuses the root cgroup, init's and its own. ---
+    if (scope == Scope::Cgroup) {
+        root.close();
+        FrogKill::TreeKillOptions opts;
+        opts.sig = sig;
+        opts.graceMs = graceMs;
+        std::string path;
+        const FrogKill::TreeKillResult r = FrogKill::killCgroup(pid, startTime, opts, path);
+        if (r.members.empty() && r.error == 0) {
+            err << "PID does not exist (or was reused)\n";
+            return 3;
+        }
+        if (r.error == EOPNOTSUPP) {
+            err << "cgroup v2 is not available\n";
+            return 3;
+        }
+        if (r.error == EINVAL || r.error == EDEADLK || r.error == ENOENT) {
+            err << "Refusing to kill cgroup " << path << "\n";
+            return 3;
+        }
+        if (r.error != 0) {
+            err << "killing cgroup " << path << " failed: " << std::strerror(r.error) << "\n";
+            return 4;
+        }
+        if (graceMs > 0 && r.survivors > 0) {
+            err << r.survivors << " process(es) still running\n";
+            return 5;
+        }
+        return 0;
+    }
+
+    // Signals every handle (children first), waits and escalates TERM -> KILL
+    // after the grace period.
+    auto doKill = [&](const std::vector<ProcHandle>& targets) -> int {
+        int error = 0;
+        const size_t running = FrogKill::terminateAll(targets, sig, graceMs, error);
+        if (error != 0) {
+            err << "signal " << sig << " failed: " << std::strerror(error) << "\n";
+            return 4;
+        }
+        if (graceMs > 0 && running > 0) {
+            err << running << " process(es) still running\n";
+            return 5;
+        }
+        return 0;
+    };
+
+    std::vector<ProcHandle> targets;
+    if (scope == Scope::Process) {
+        targets.push_back(std::move(root));
+        return doKill(targets);
+    }
+
+    // --- Tree mode: freeze the subtree (cgroup freezer or SIGSTOP sweep) so
+    // a fork loop cannot outrun us, then signal it. ---
+    root.close();
+    FrogKill::TreeKillOptions opts;
+    opts.sig = sig;
+    opts.graceMs = graceMs;
+    const FrogKill::TreeKillResult r = FrogKill::killTree(pid, startTime, opts);
+    if (r.members.empty() && r.error == 0) {
+        err << "PID does not exist (or was reused)\n";
+        return 3;
+    }
+    if (!r.converged) err << "warning: tree did not stop growing before the deadline\n";
+    if (r.error != 0) {
+        err << "signal " << sig << " failed: " << std::strerror(r.error) << "\n";
+        return 4;
+    }
+    if (graceMs > 0 && r.survivors > 0) {
+        err << r.survivors << " process(es) still running\n";
+        return 5;
+    }
+    return 0;
+}
+
+// Signals each target on its own; all share one grace period. `codes`
+// gets a per-PID status (same values as the exit status); returns the
+// highest of them.
+static int runKillBatch(const std::vector<BatchEntry>& entries, int sig, int graceMs, std::vector<int>& codes,
+                        std::ostream& err) {
+    codes.assign(entries.size(), 0);
+    std::vector<ProcHandle> handles;
+    std::vector<size_t> entryOf;   // handle -> entry
+    handles.reserve(entries.size());
+    entryOf.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const int pid = entries[i].pid;
+        if (pid <= 1) {
+            err << pid << ": refusing to signal PID <= 1\n";
+            codes[i] = 3;
+            continue;
+        }
+        ProcHandle h;
+        const int e = h.open(pid, entries[i].startTime);
+        if (e != 0) {
+            if (e != ESRCH) err << pid << ": pidfd_open failed: " << std::strerror(e) << "\n";
+            codes[i] = e == ESRCH ? 3 : 4;
+            continue;
+        }
+        handles.push_back(std::move(h));
+        entryOf.push_back(i);
+    }
+
+    std::vector<int> errors;
+    FrogKill::terminateEach(handles, sig, graceMs, errors);
+    for (size_t k = 0; k < handles.size(); ++k) {
+        const size_t i = entryOf[k];
+        if (errors[k] == ESRCH) {
+            codes[i] = 3;
+        } else if (errors[k] != 0) {
+            err << entries[i].pid << ": signal " << sig << " failed: " << std::strerror(errors[k]) << "\n";
+            codes[i] = 4;
+        } else if (graceMs > 0 && !handles[k].exited()) {
+            err << entries[i].pid << ": still running\n";
+            codes[i] = 5;
+        }
+    }
+    return codes.empty() ? 0 : *std::max_element(codes.begin(), codes.end());
+}
+
+// Parses "PID[:START],PID[:START],..." (at most kMaxBatch entries).
+static bool parsePidList(const std::string& list, std::vector<BatchEntry>& out) {
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        const size_t comma = std::min(list.find(',', pos), list.size());
+        const std::string item = list.substr(pos, comma - pos);
+        const size_t colon = item.find(':');
+        long long pid = 0;
+        long long start = 0;
+        if (!parseInt(item.substr(0, colon), pid) || pid <= 0 || pid > INT32_MAX) return false;
+        if (colon != std::string::npos && (!parseInt(item.substr(colon + 1), start) || start < 0)) return false;
+        if (out.size() >= FrogKill::HelperProto::kMaxBatch) return false;
+        out.push_back(BatchEntry{(int32_t)pid, 0, (uint64_t)start});
+        pos = comma + 1;
+    }
+    return !out.empty();
+}
+
+static bool readFull(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        const ssize_t n = ::read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void* buf, size_t len) {
+    const char* p = static_cast<const char*>(buf);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Serves kill requests from the GUI (see helper_protocol.h) until stdin is
+// closed, a protocol error occurs or no request arrives for idleMs. Every
+// request goes through the same checks as the command line.
+static int runSession(int idleMs) {
+    namespace Proto = FrogKill::HelperProto;
+    std::signal(SIGPIPE, SIG_IGN);
+    std::vector<BatchEntry> entries;
+    std::vector<int32_t> codes;
+    for (;;) {
+        pollfd pfd{STDIN_FILENO, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, idleMs);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return 0;   // idle timeout
+
+        uint32_t len = 0;
+        if (!readFull(STDIN_FILENO, &len, sizeof(len))) return 0;   // caller went away
+        if (len < sizeof(Proto::Request) || len > Proto::kMaxFrame) {
+            std::cerr << "session: invalid frame length " << len << "\n";
+            return 2;
+        }
+        Proto::Request req{};
+        if (!readFull(STDIN_FILENO, &req, sizeof(req))) return 0;
+        if (req.version != Proto::kVersion) {
+            std::cerr << "session: unsupported protocol version " << req.version << "\n";
+            return 2;
+        }
+        const uint32_t count = req.op == Proto::Op::KillBatch ? req.count : 0;
+        if (count > Proto::kMaxBatch || len != sizeof(req) + count * sizeof(BatchEntry)) {
+            std::cerr << "session: invalid frame length " << len << "\n";
+            return 2;
+        }
+        entries.resize(count);
+        if (count > 0 && !readFull(STDIN_FILENO, entries.data(), count * sizeof(BatchEntry))) return 0;
+        if (req.op == Proto::Op::Quit) return 0;
+
+        std::ostringstream err;
+        int code = 2;
+        codes.assign(count, 2);
+        if (req.op != Proto::Op::Kill && req.op != Proto::Op::KillBatch) {
+            err << "Unknown request\n";
+        } else if (req.sig != SIGTERM && req.sig != SIGKILL) {
+            err << "Invalid signal (allowed: TERM|KILL)\n";
+        } else if (req.graceMs < 0 || req.graceMs > 600000) {
+            err << "Invalid grace period (0..600000 ms)\n";
+        } else if (req.scope != Scope::Process && req.scope != Scope::Tree && req.scope != Scope::Cgroup) {
+            err << "Invalid scope\n";
+        } else if (req.op == Proto::Op::KillBatch) {
+            if (req.scope != Scope::Process || count == 0) {
+                err << "Invalid batch\n";
+            } else if (std::any_of(entries.begin(), entries.end(), [](const BatchEntry& e) { return e.reserved != 0; })) {
+                err << "Invalid batch entry\n";
+            } else {
+                code = runKillBatch(entries, req.sig, req.graceMs, codes, err);
+            }
+        } else {
+            code = runKill(req.pid, req.sig, req.startTime, req.graceMs, req.scope, err);
+        }
+
+        const size_t codesBytes = codes.size() * sizeof(int32_t);
+        const std::string text = err.str().substr(0, Proto::kMaxFrame - sizeof(Proto::ReplyHeader) - codesBytes);
+        const Proto::ReplyHeader reply{Proto::kVersion, code, count};
+        const uint32_t replyLen = (uint32_t)(sizeof(reply) + codesBytes + text.size());
+        if (!writeFull(STDOUT_FILENO, &replyLen, sizeof(replyLen)) ||
+            !writeFull(STDOUT_FILENO, &reply, sizeof(reply)) ||
+            !writeFull(STDOUT_FILENO, codes.data(), codesBytes) ||
+            !writeFull(STDOUT_FILENO, text.data(), text.size())) {
+            return 0;
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     int pid = -1;
     int sig = 0;
     bool tree = false;
+    bool cgroup = false;               // the cgroup of --pid, never a path from the caller
+    unsigned long long startTime = 0;  // 0 = don't check the generation
+    int graceMs = 0;                   // 0 = signal and return
+    std::vector<BatchEntry> batch;     // --pids
+    bool session = false;
+    int idleSec = 300;
 
     for (int i = 1; i < argc; i++) {
         std::string a = argv[i];
@@ -39,6 +310,11 @@ int main(int argc, char** argv) {
                 return 2;
             }
             pid = (int)v;
+        } else if (a == "--pids" && i + 1 < argc) {
+            if (!batch.empty() || !parsePidList(argv[++i], batch)) {
+                std::cerr << "Invalid PID list (PID[:START],... up to " << FrogKill::HelperProto::kMaxBatch << ")\n";
+                return 2;
+            }
         } else if (a == "--sig" && i + 1 < argc) {
             std::string s = argv[++i];
             if (s == "TERM") sig = SIGTERM;
@@ -47,11 +323,36 @@ int main(int argc, char** argv) {
                 std::cerr << "Invalid signal (allowed: TERM|KILL)\n";
                 return 2;
             }
+        } else if (a == "--start-time" && i + 1 < argc) {
+            long long v = 0;
+            if (!parseInt(argv[++i], v) || v < 0) {
+                std::cerr << "Invalid start time\n";
+                return 2;
+            }
+            startTime = (unsigned long long)v;
+        } else if (a == "--grace" && i + 1 < argc) {
+            long long v = 0;
+            if (!parseInt(argv[++i], v) || v < 0 || v > 600000) {
+                std::cerr << "Invalid grace period (0..600000 ms)\n";
+                return 2;
+            }
+            graceMs = (int)v;
         } else if (a == "--help" || a == "-h") {
             usage();
             return 0;
         } else if (a == "--tree") {
             tree = true;
+        } else if (a == "--cgroup") {
+            cgroup = true;
+        } else if (a == "--session") {
+            session = true;
+        } else if (a == "--idle-timeout" && i + 1 < argc) {
+            long long v = 0;
+            if (!parseInt(argv[++i], v) || v < 1 || v > 3600) {
+                std::cerr << "Invalid idle timeout (1..3600 s)\n";
+                return 2;
+            }
+            idleSec = (int)v;
         } else {
             std::cerr << "Unknown argument: " << a << "\n";
             usage();
@@ -59,92 +360,34 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (pid <= 0 || sig == 0) {
-        usage();
-        return 2;
-    }
-
-    if (pid <= 1) {
-        std::cerr << "Refusing to signal PID <= 1\n";
-        return 3;
+    if (session) {
+        if (pid != -1 || sig != 0 || tree || cgroup || !batch.empty()) {
+            usage();
+            return 2;
+        }
+        return runSession(idleSec * 1000);
     }
 
-    // Validate existence
-    if (kill(pid, 0) != 0 && errno == ESRCH) {
-        std::cerr << "PID does not exist\n";
-        return 3;
+    if (!batch.empty()) {
+        if (pid != -1 || sig == 0 || tree || cgroup || startTime != 0) {
+            usage();
+            return 2;
+        }
+        // One "<pid> <status>" line per target on stdout; diagnostics on stderr.
+        std::vector<int> codes;
+        const int worst = runKillBatch(batch, sig, graceMs, codes, std::cerr);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            std::cout << batch[i].pid << ' ' << codes[i] << '\n';
+        }
+        return worst;
     }
 
-    auto doKill = [&](int targetPid) -> bool {
-        if (targetPid <= 1) return true;
-        if (kill(targetPid, sig) == 0) return true;
-        if (errno == ESRCH) return true;
-        std::cerr << "kill(" << targetPid << "," << sig << ") failed: " << std::strerror(errno) << "\n";
-        return false;
-    };
-
-    if (!tree) {
-        if (!doKill(pid)) return 4;
-        return 0;
+    if (pid <= 0 || sig == 0 || (tree && cgroup)) {
+        usage();
+        return 2;
     }
 
-    // --- Tree mode: build PPID -> children map from /proc and kill children first. ---
-    std::unordered_map<int, std::vector<int>> children;
-    children.reserve(8192);
-
-    auto readPpid = [](int p, int& outPpid) -> bool {
-        std::string path = "/proc/" + std::to_string(p) + "/stat";
-        std::ifstream f(path);
-        if (!f) return false;
-        std::string line;
-        std::getline(f, line);
-        if (line.empty()) return false;
-        const auto rparen = line.rfind(')');
-        if (rparen == std::string::npos || rparen + 2 >= line.size()) return false;
-        std::istringstream iss(line.substr(rparen + 2));
-        char state = 0;
-        int ppid = -1;
-        iss >> state >> ppid;
-        if (!iss || ppid < 0) return false;
-        outPpid = ppid;
-        return true;
-    };
-
-    for (const auto& entry : std::filesystem::directory_iterator("/proc")) {
-        if (!entry.is_directory()) continue;
-        const auto name = entry.path().filename().string();
-        if (name.empty() || name[0] < '0' || name[0] > '9') continue;
-        long long v = 0;
-        if (!parseInt(name, v)) continue;
-        const int childPid = (int)v;
-        int ppid = -1;
-        if (!readPpid(childPid, ppid)) continue;
-        if (childPid > 1 && ppid >= 0) {
-            children[ppid].push_back(childPid);
-        }
-    }
-
-    std::vector<int> stack1;
-    std::vector<int> stack2;
-    stack1.reserve(256);
-    stack2.reserve(256);
-    stack1.push_back(pid);
-    while (!stack1.empty()) {
-        const int cur = stack1.back();
-        stack1.pop_back();
-        stack2.push_back(cur);
-        auto it = children.find(cur);
-        if (it == children.end()) continue;
-        for (int c : it->second) stack1.push_back(c);
-    }
-    std::reverse(stack2.begin(), stack2.end());
-
-    int ok = 0;
-    for (int target : stack2) {
-        if (doKill(target)) ++ok;
-        else return 4;
-    }
-    (void)ok;
-
-    return 0;
+    const Scope scope = tree ? Scope::Tree : cgroup ? Scope::Cgroup : Scope::Process;
+    return runKill(pid, sig, startTime, graceMs, scope, std::cerr);
 }
+
@@ -8,6 +8,9 @@
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QAction>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
 #include "main_window.h"
 
 namespace FrogKill {
@@ -59,10 +62,46 @@ bool AppController::trySendCommand(const QByteArray& cmd) {
 void AppController::ensureWindow() {
     if (!m_window) {
         m_window = new MainWindow();
+        m_window->setScanThreads(m_scanThreads);
+        if (m_procEvents) m_window->setProcEvents(true);
+        m_window->setKillGraceMs(m_killGraceMs);
+        if (m_elevatedSessionSec > 0) m_window->setElevatedSessionSec(m_elevatedSessionSec);
+        m_window->setRefreshIntervals(m_refreshMs, m_headerMs);
+        m_window->setRefreshBudget(m_refreshBudget);
+        if (m_historyMiB >= 0) m_window->setHistoryMiB(m_historyMiB);
+        if (!m_recordPath.isEmpty()) m_window->setRecordPath(m_recordPath);
+        if (m_flight) m_window->setFlightRecorder(m_flight.get());
         connect(m_window, &QObject::destroyed, this, [this] { m_window = nullptr; });
     }
 }
 
+bool AppController::startFlightRecorder() {
+    if (m_flight) return true;
+    FlightOptions options = m_flightOptions;
+    if (options.path.empty()) {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+        if (dir.isEmpty() || !QDir().mkpath(dir)) {
+            qWarning() << "Flight recorder: no writable data directory.";
+            return false;
+        }
+        options.path = QFile::encodeName(dir + "/flight.log").toStdString();
+    }
+    auto recorder = std::make_unique<FlightRecorder>(std::move(options));
+    std::string error;
+    if (!recorder->start(&error)) {
+        qWarning() << "Flight recorder:" << QString::fromStdString(error);
+        return false;
+    }
+    m_flight = std::move(recorder);
+    if (m_window) m_window->setFlightRecorder(m_flight.get());
+    return true;
+}
+
+bool AppController::openReplay(const QString& path) {
+    ensureWindow();
+    return m_window->openReplay(path);
+}
+
 void AppController::ensureTray() {
     if (m_tray) return;
     if (!QSystemTrayIcon::isSystemTrayAvailable()) {
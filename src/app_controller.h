@@ -2,6 +2,10 @@
 #include <QObject>
 #include <QLocalServer>
 
+#include <memory>
+
+#include "flight_recorder.h"
+
 class QSystemTrayIcon;
 class QMenu;
 class QAction;
@@ -17,6 +21,30 @@ public:
     ~AppController() override;
 
     void setSingleInstanceEnabled(bool enabled) { m_singleInstance = enabled; }
+    // Threads used by the /proc scanner (1 = serial, 0 = one per CPU).
+    void setScanThreads(int threads) { m_scanThreads = threads; }
+    // Track processes with proc connector events instead of walking /proc.
+    void setProcEvents(bool enabled) { m_procEvents = enabled; }
+    // SIGTERM -> SIGKILL escalation delay for kills (0 = never escalate).
+    void setKillGraceMs(int ms) { m_killGraceMs = ms; }
+    // Idle timeout of the persistent elevated helper session (0 = off).
+    void setElevatedSessionSec(int sec) { m_elevatedSessionSec = sec; }
+    // Process table and header refresh intervals.
+    void setRefreshIntervals(int tableMs, int headerMs) { m_refreshMs = tableMs; m_headerMs = headerMs; }
+    // CPU share (of one core) above which the table refreshes less often.
+    void setRefreshBudget(double fraction) { m_refreshBudget = fraction; }
+    // Memory for the per-process history column (0 = off).
+    void setHistoryMiB(int mib) { m_historyMiB = mib; }
+    // Record the session to this file (see SnapshotWriter).
+    void setRecordPath(const QString& path) { m_recordPath = path; }
+
+    // Background flight recorder (see FlightRecorder); the path is filled in
+    // by startFlightRecorder() when empty.
+    void setFlightOptions(const FlightOptions& options) { m_flightOptions = options; }
+    bool startFlightRecorder();
+
+    // Opens a recording in the window instead of the live system.
+    bool openReplay(const QString& path);
 
     // Starts the IPC server (single instance). Safe to call multiple times.
     bool startServer();
@@ -38,6 +66,17 @@ private:
     void ensureWindow();
 
     bool m_singleInstance{true};
+    int m_scanThreads{1};
+    bool m_procEvents{false};
+    int m_killGraceMs{5000};
+    int m_elevatedSessionSec{0};
+    int m_refreshMs{1000};
+    int m_headerMs{500};
+    double m_refreshBudget{0.10};
+    int m_historyMiB{-1};   // -1 = the window's default
+    QString m_recordPath;
+    FlightOptions m_flightOptions;
+    std::unique_ptr<FlightRecorder> m_flight;
     QLocalServer m_server;
     MainWindow* m_window{nullptr};
 
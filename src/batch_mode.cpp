@@ -0,0 +1,413 @@
+#include "batch_mode.h"
+#include "proc_filter.h"
+#include "procfs.h"
+#include "snapshot_file.h"
+#include "system_sampler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+namespace FrogKill {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+enum class Format { Json, Csv, Tsv, None };
+enum class SortKey { Cpu, Rss, Pid, Name, User };
+
+struct BatchOptions {
+    int intervalMs{1000};
+    unsigned long long count{0};   // 0 = until stdout closes
+    Format format{Format::Tsv};
+    size_t top{0};                 // 0 = every matching process
+    SortKey sort{SortKey::Cpu};
+    std::string filter;
+    std::string record;            // recording file, if any
+    int scanThreads{1};
+    bool procEvents{false};
+};
+
+constexpr const char* kUsage =
+    "Usage: frogkill --batch [options]\n"
+    "Print process snapshots to stdout without a GUI.\n"
+    "\n"
+    "  --interval DURATION  time between snapshots: 500ms, 2s, 1m (default 1s)\n"
+    "  --count N            stop after N snapshots (default 0 = run until stdout closes)\n"
+    "  --format FORMAT      json (one object per line, with system totals), csv, tsv (default)\n"
+    "                       or none (with --record)\n"
+    "  --top N              only the first N processes of each snapshot (default 0 = all)\n"
+    "  --sort KEY           cpu, rss (descending), pid, name or user (default cpu)\n"
+    "  --filter QUERY       same syntax as the search box, e.g. \"user:root cpu>5\"\n"
+    "  --scan-threads N     threads used to scan /proc (default 1; 0 = one per CPU)\n"
+    "  --proc-events        track processes via the kernel proc connector\n"
+    "  --record FILE        also record every snapshot (all processes) to FILE, for --replay\n"
+    "\n"
+    "The first snapshot is printed one interval after start, when CPU % can be measured.\n";
+
+bool parseInt(std::string_view s, long long& out) {
+    const auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && p == s.data() + s.size();
+}
+
+// "500ms", "2s", "1.5s", "1m"; a bare number is milliseconds.
+bool parseDurationMs(std::string_view s, int& out) {
+    double v = 0.0;
+    const auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc() || p == s.data()) return false;
+    const std::string_view unit(p, (size_t)(s.data() + s.size() - p));
+    if (unit == "s") v *= 1000.0;
+    else if (unit == "m" || unit == "min") v *= 60'000.0;
+    else if (!unit.empty() && unit != "ms") return false;
+    if (!(v >= 1.0 && v <= 86'400'000.0)) return false;
+    out = (int)v;
+    return true;
+}
+
+// Returns -1 to continue, otherwise the exit code.
+int parseArgs(int argc, char** argv, BatchOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        std::string_view value;
+        bool inlineValue = false;
+        if (const size_t eq = arg.find('='); arg.starts_with("--") && eq != std::string_view::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+            inlineValue = true;
+        }
+        auto takeValue = [&]() -> bool {
+            if (inlineValue) return true;
+            if (i + 1 >= argc) return false;
+            value = argv[++i];
+            return true;
+        };
+        auto bad = [&]() {
+            std::fprintf(stderr, "frogkill: invalid value for %.*s: '%.*s'\n",
+                         (int)arg.size(), arg.data(), (int)value.size(), value.data());
+            return 2;
+        };
+        long long n = 0;
+
+        if (arg == "--batch") continue;
+        if (arg == "-h" || arg == "--help") {
+            std::fputs(kUsage, stdout);
+            return 0;
+        }
+        if (arg == "--proc-events") {
+            o.procEvents = true;
+            continue;
+        }
+        if (arg != "--interval" && arg != "--count" && arg != "--format" && arg != "--top"
+            && arg != "--sort" && arg != "--filter" && arg != "--scan-threads" && arg != "--record") {
+            std::fprintf(stderr, "frogkill: unknown batch option '%s'\n%s", argv[i], kUsage);
+            return 2;
+        }
+        if (!takeValue()) {
+            std::fprintf(stderr, "frogkill: missing value for %.*s\n", (int)arg.size(), arg.data());
+            return 2;
+        }
+
+        if (arg == "--interval") {
+            if (!parseDurationMs(value, o.intervalMs)) return bad();
+        } else if (arg == "--count") {
+            if (!parseInt(value, n) || n < 0) return bad();
+            o.count = (unsigned long long)n;
+        } else if (arg == "--top") {
+            if (!parseInt(value, n) || n < 0) return bad();
+            o.top = (size_t)n;
+        } else if (arg == "--scan-threads") {
+            if (!parseInt(value, n) || n < 0 || n > 1024) return bad();
+            o.scanThreads = (int)n;
+        } else if (arg == "--format") {
+            if (value == "json") o.format = Format::Json;
+            else if (value == "csv") o.format = Format::Csv;
+            else if (value == "tsv") o.format = Format::Tsv;
+            else if (value == "none") o.format = Format::None;
+            else return bad();
+        } else if (arg == "--sort") {
+            if (value == "cpu") o.sort = SortKey::Cpu;
+            else if (value == "rss" || value == "mem" || value == "ram") o.sort = SortKey::Rss;
+            else if (value == "pid") o.sort = SortKey::Pid;
+            else if (value == "name") o.sort = SortKey::Name;
+            else if (value == "user") o.sort = SortKey::User;
+            else return bad();
+        } else if (arg == "--filter") {
+            o.filter.assign(value);
+        } else if (arg == "--record") {
+            if (value.empty()) return bad();
+            o.record.assign(value);
+        }
+    }
+    if (o.format == Format::None && o.record.empty()) {
+        std::fputs("frogkill: --format none only makes sense with --record\n", stderr);
+        return 2;
+    }
+    return -1;
+}
+
+long long wallClockMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1'000'000;
+}
+
+// Appends to a std::string that is cleared, not freed, between ticks.
+class Writer {
+public:
+    void clear() { m_buf.clear(); }
+    const std::string& data() const { return m_buf; }
+
+    void raw(std::string_view s) { m_buf.append(s); }
+    void ch(char c) { m_buf.push_back(c); }
+
+    void integer(long long v) {
+        char tmp[24];
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        m_buf.append(tmp, res.ptr);
+    }
+    // One decimal, like the GUI.
+    void tenths(double v) {
+        char tmp[32];
+        const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::fixed, 1);
+        m_buf.append(tmp, res.ptr);
+    }
+
+    void json(std::string_view s) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        m_buf.push_back('"');
+        for (const char c : s) {
+            const auto u = (unsigned char)c;
+            if (c == '"' || c == '\\') {
+                m_buf.push_back('\\');
+                m_buf.push_back(c);
+            } else if (u < 0x20) {
+                m_buf.append("\\u00");
+                m_buf.push_back(kHex[u >> 4]);
+                m_buf.push_back(kHex[u & 15]);
+            } else {
+                m_buf.push_back(c);
+            }
+        }
+        m_buf.push_back('"');
+    }
+    // RFC 4180: quoted only when needed, quotes doubled.
+    void csv(std::string_view s) {
+        if (s.find_first_of(",\"\r\n") == std::string_view::npos) {
+            m_buf.append(s);
+            return;
+        }
+        m_buf.push_back('"');
+        for (const char c : s) {
+            if (c == '"') m_buf.push_back('"');
+            m_buf.push_back(c);
+        }
+        m_buf.push_back('"');
+    }
+    // TSV has no quoting: separators inside a field become spaces.
+    void tsv(std::string_view s) {
+        for (const char c : s) m_buf.push_back(c == '\t' || c == '\n' || c == '\r' ? ' ' : c);
+    }
+
+private:
+    std::string m_buf;
+};
+
+// Rows of `t` that pass the filter, in output order, cut to `top`.
+void selectRows(const ProcTable& t, const ProcFilter& filter, const BatchOptions& o,
+                std::vector<uint32_t>& rows) {
+    rows.clear();
+    for (uint32_t r = 0; r < (uint32_t)t.size(); ++r) {
+        if (filter.accepts(r)) rows.push_back(r);
+    }
+
+    auto less = [&](uint32_t a, uint32_t b) {
+        switch (o.sort) {
+        case SortKey::Cpu:
+            if (t.cpuPercent[a] != t.cpuPercent[b]) return t.cpuPercent[a] > t.cpuPercent[b];
+            break;
+        case SortKey::Rss:
+            if (t.rssMiB[a] != t.rssMiB[b]) return t.rssMiB[a] > t.rssMiB[b];
+            break;
+        case SortKey::Pid: break;
+        case SortKey::Name:
+            if (const int c = t.name(a).compare(t.name(b))) return c < 0;
+            break;
+        case SortKey::User:
+            if (const int c = t.user(a).compare(t.user(b))) return c < 0;
+            break;
+        }
+        return t.pid[a] < t.pid[b];
+    };
+
+    // Rows come in PID order, which is already the answer for --sort pid.
+    if (o.sort == SortKey::Pid) {
+        if (o.top && rows.size() > o.top) rows.resize(o.top);
+    } else if (o.top && rows.size() > o.top) {
+        std::partial_sort(rows.begin(), rows.begin() + (ptrdiff_t)o.top, rows.end(), less);
+        rows.resize(o.top);
+    } else {
+        std::sort(rows.begin(), rows.end(), less);
+    }
+}
+
+void writeSnapshot(Writer& w, const BatchOptions& o, unsigned long long seq, long long timeMs,
+                   const ProcTable& t, const SystemSnapshot& sys, const std::vector<uint32_t>& rows) {
+    if (o.format == Format::Json) {
+        w.raw("{\"seq\":");
+        w.integer((long long)seq);
+        w.raw(",\"time_ms\":");
+        w.integer(timeMs);
+        w.raw(",\"cpu\":");
+        w.tenths(sys.cpuPercent);
+        w.raw(",\"mem_used_mib\":");
+        w.tenths(sys.memUsedMiB);
+        w.raw(",\"mem_total_mib\":");
+        w.tenths(sys.memTotalMiB);
+        w.raw(",\"swap_used_mib\":");
+        w.tenths(sys.swapUsedMiB);
+        w.raw(",\"swap_total_mib\":");
+        w.tenths(sys.swapTotalMiB);
+        w.raw(",\"procs\":");
+        w.integer((long long)t.size());
+        w.raw(",\"processes\":[");
+        for (size_t k = 0; k < rows.size(); ++k) {
+            const uint32_t r = rows[k];
+            if (k) w.ch(',');
+            w.raw("{\"pid\":");
+            w.integer(t.pid[r]);
+            w.raw(",\"ppid\":");
+            w.integer(t.ppid[r]);
+            w.raw(",\"user\":");
+            w.json(t.user(r));
+            w.raw(",\"cpu\":");
+            w.tenths(t.cpuPercent[r]);
+            w.raw(",\"rss_mib\":");
+            w.tenths(t.rssMiB[r]);
+            w.raw(",\"name\":");
+            w.json(t.name(r));
+            w.ch('}');
+        }
+        w.raw("]}\n");
+        return;
+    }
+
+    const char sep = o.format == Format::Csv ? ',' : '\t';
+    for (const uint32_t r : rows) {
+        w.integer((long long)seq);
+        w.ch(sep);
+        w.integer(timeMs);
+        w.ch(sep);
+        w.integer(t.pid[r]);
+        w.ch(sep);
+        w.integer(t.ppid[r]);
+        w.ch(sep);
+        if (o.format == Format::Csv) w.csv(t.user(r));
+        else w.tsv(t.user(r));
+        w.ch(sep);
+        w.tenths(t.cpuPercent[r]);
+        w.ch(sep);
+        w.tenths(t.rssMiB[r]);
+        w.ch(sep);
+        if (o.format == Format::Csv) w.csv(t.name(r));
+        else w.tsv(t.name(r));
+        w.ch('\n');
+    }
+}
+
+// False once stdout is gone (reader exited, disk full...).
+bool flushOut(const std::string& s) {
+    if (!s.empty() && std::fwrite(s.data(), 1, s.size(), stdout) != s.size()) return false;
+    return std::fflush(stdout) == 0;
+}
+
+} // namespace
+
+int runBatch(int argc, char** argv) {
+    BatchOptions o;
+    const int rc = parseArgs(argc, argv, o);
+    if (rc >= 0) return rc;
+
+    // A closed pipe (`frogkill --batch | head`) ends the run through a
+    // failed write instead of killing the process.
+    std::signal(SIGPIPE, SIG_IGN);
+    // Ctrl+C while recording still finishes the file (with its index).
+    if (!o.record.empty()) {
+        std::signal(SIGINT, [](int) { g_stop = 1; });
+        std::signal(SIGTERM, [](int) { g_stop = 1; });
+    }
+
+    ProcSampler procs;
+    procs.setThreads(o.scanThreads);
+    if (o.procEvents && !procs.setEventDriven(true)) {
+        std::fputs("frogkill: proc connector unavailable (needs CAP_NET_ADMIN); scanning /proc every tick.\n", stderr);
+    }
+    SystemSampler sys;
+    ProcFilter filter;
+    filter.setQuery(o.filter);
+
+    SnapshotWriter recorder;
+    if (!o.record.empty() && !recorder.open(o.record.c_str())) {
+        std::fprintf(stderr, "frogkill: cannot create %s: %s\n", o.record.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    ProcTable table;
+    std::vector<uint32_t> rows;
+    Writer w;
+
+    if (o.format == Format::Csv || o.format == Format::Tsv) {
+        w.raw(o.format == Format::Csv ? "seq,time_ms,pid,ppid,user,cpu,rss_mib,name\n"
+                                      : "seq\ttime_ms\tpid\tppid\tuser\tcpu\trss_mib\tname\n");
+        if (!flushOut(w.data())) return 0;
+    }
+
+    // Baseline for the CPU deltas; nothing is printed for it.
+    const auto interval = std::chrono::milliseconds(o.intervalMs);
+    auto next = Clock::now() + interval;
+    procs.sample(table);
+    sys.sample();
+
+    for (unsigned long long seq = 1; o.count == 0 || seq <= o.count; ++seq) {
+        std::this_thread::sleep_until(next);
+        if (g_stop) break;
+        const auto t0 = Clock::now();
+
+        procs.sample(table);
+        const SystemSnapshot s = sys.sample();
+        const long long timeMs = wallClockMs();
+        if (recorder.isOpen() && !recorder.append(table, s, seq, timeMs)) {
+            std::fprintf(stderr, "frogkill: cannot write %s: %s\n", o.record.c_str(), std::strerror(errno));
+            return 1;
+        }
+
+        if (o.format != Format::None) {
+            filter.apply(table, seq);
+            selectRows(table, filter, o, rows);
+            w.clear();
+            writeSnapshot(w, o, seq, timeMs, table, s, rows);
+            if (!flushOut(w.data())) return 0;
+        }
+
+        // Fixed-rate schedule, dropping ticks a slow sample overran (as
+        // SamplerThread does).
+        const auto t1 = Clock::now();
+        next = t0 + interval;
+        if (next <= t1) next += ((t1 - next) / interval + 1) * interval;
+    }
+    return 0;
+}
+
+} // namespace FrogKill
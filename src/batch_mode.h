@@ -0,0 +1,14 @@
+#pragma once
+
+namespace FrogKill {
+
+// Headless mode (`frogkill --batch ...`): samples processes and system
+// totals on a fixed schedule and streams them to stdout as JSON lines,
+// CSV or TSV, without creating a QApplication or any widget. `argv` is
+// the full command line; returns the process exit code.
+//
+// Every buffer is recycled between ticks, so memory stays flat however
+// long it runs.
+int runBatch(int argc, char** argv);
+
+} // namespace FrogKill
@@ -0,0 +1,112 @@
+#include "flight_dialog.h"
+#include "flight_recorder.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTabWidget>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace FrogKill {
+
+// Rows per list.
+static constexpr size_t kTopRows = 15;
+
+static QTreeWidget* makeList(QWidget* parent, const QStringList& headers) {
+    auto* list = new QTreeWidget(parent);
+    list->setHeaderLabels(headers);
+    list->setRootIsDecorated(false);
+    list->setUniformRowHeights(true);
+    list->setAlternatingRowColors(true);
+    list->setSelectionMode(QAbstractItemView::NoSelection);
+    list->header()->setStretchLastSection(false);
+    list->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    return list;
+}
+
+static void fill(QTreeWidget* list, const std::vector<FlightSummary::Item>& items, int precision) {
+    list->clear();
+    for (const FlightSummary::Item& item : items) {
+        auto* row = new QTreeWidgetItem(list);
+        row->setText(0, QString::fromUtf8(item.name.data(), (qsizetype)item.name.size()));
+        row->setText(1, QString::number(item.pid));
+        row->setText(2, QString::number(item.value, 'f', precision));
+        row->setTextAlignment(1, Qt::AlignRight);
+        row->setTextAlignment(2, Qt::AlignRight);
+    }
+}
+
+FlightDialog::FlightDialog(const FlightRecorder* recorder, QWidget* parent)
+    : QDialog(parent), m_recorder(recorder) {
+    setWindowTitle("Últimos minutos");
+    resize(620, 460);
+    auto* root = new QVBoxLayout(this);
+
+    auto* top = new QHBoxLayout();
+    top->addWidget(new QLabel("Período:", this));
+    m_window = new QComboBox(this);
+    for (const int minutes : {5, 15, 30, 60, 180}) m_window->addItem(QString("últimos %1 min").arg(minutes), minutes);
+    m_window->setCurrentIndex(1);
+    top->addWidget(m_window);
+    m_info = new QLabel(this);
+    top->addWidget(m_info, 1);
+    auto* again = new QPushButton("Atualizar", this);
+    top->addWidget(again);
+    root->addLayout(top);
+
+    auto* tabs = new QTabWidget(this);
+    m_cpu = makeList(this, {"Processo", "PID", "CPU média %"});
+    m_rss = makeList(this, {"Processo", "PID", "Pico RAM (MiB)"});
+    m_spawns = makeList(this, {"Programa", "Último PID", "Processos"});
+    tabs->addTab(m_cpu, "CPU");
+    tabs->addTab(m_rss, "Memória");
+    tabs->addTab(m_spawns, "Processos criados");
+    root->addWidget(tabs, 1);
+
+    m_cost = new QLabel(this);
+    m_cost->setWordWrap(true);
+    root->addWidget(m_cost);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    root->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(again, &QPushButton::clicked, this, &FlightDialog::refresh);
+    connect(m_window, &QComboBox::currentIndexChanged, this, &FlightDialog::refresh);
+    refresh();
+}
+
+void FlightDialog::refresh() {
+    const FlightSummary s = m_recorder->summarize(m_window->currentData().toInt(), kTopRows);
+    if (s.samples == 0) {
+        m_info->setText("nenhuma amostra neste período.");
+    } else {
+        const auto hhmmss = [](long long ms) { return QDateTime::fromMSecsSinceEpoch(ms).toString("HH:mm:ss"); };
+        m_info->setText(QString("%1 – %2, %3 amostras, %4 processos criados")
+                            .arg(hhmmss(s.fromMs), hhmmss(s.toMs))
+                            .arg(s.samples)
+                            .arg(s.forks));
+    }
+    fill(m_cpu, s.cpu, 1);
+    fill(m_rss, s.rss, 1);
+    fill(m_spawns, s.spawns, 0);
+
+    // The recorder's own cost, measured on its thread.
+    const FlightRecorder::Stats st = m_recorder->stats();
+    const double share = st.wallSeconds > 0.0 ? 100.0 * st.cpuSeconds / st.wallSeconds : 0.0;
+    m_cost->setText(QString("Gravador: %1 amostras desde o início, uma a cada %2 s; custo medido %3% de um núcleo "
+                            "(limite %4%). Guarda %5 de %6 amostras.")
+                        .arg(st.samples)
+                        .arg(st.intervalMs / 1000.0, 0, 'f', 1)
+                        .arg(share, 0, 'f', 3)
+                        .arg(m_recorder->options().budget * 100.0, 0, 'f', 3)
+                        .arg(st.records)
+                        .arg(st.capacity));
+}
+
+} // namespace FrogKill
@@ -0,0 +1,33 @@
+#pragma once
+#include <QDialog>
+
+class QComboBox;
+class QLabel;
+class QTreeWidget;
+
+namespace FrogKill {
+
+class FlightRecorder;
+
+// "Últimos minutos": what the daemon's flight recorder saw in a recent
+// window — top processes by mean CPU, by peak RAM, and the programs that
+// started the most processes.
+class FlightDialog : public QDialog {
+    Q_OBJECT
+public:
+    FlightDialog(const FlightRecorder* recorder, QWidget* parent = nullptr);
+
+public slots:
+    void refresh();
+
+private:
+    const FlightRecorder* m_recorder;
+    QComboBox* m_window{nullptr};
+    QLabel* m_info{nullptr};
+    QTreeWidget* m_cpu{nullptr};
+    QTreeWidget* m_rss{nullptr};
+    QTreeWidget* m_spawns{nullptr};
+    QLabel* m_cost{nullptr};
+};
+
+} // namespace FrogKill
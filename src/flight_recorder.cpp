@@ -0,0 +1,401 @@
+#include "flight_recorder.h"
+#include "proc_table.h"
+#include "procfs.h"
+#include "system_sampler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+using FlightFormat::Entry;
+using FlightFormat::Record;
+using FlightFormat::kTop;
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'R', 'O', 'G', 'F', 'L', 'T', '\0'};
+constexpr uint32_t kVersion = 1;
+
+long long wallClockMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1'000'000;
+}
+
+long long threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (long long)ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+}
+
+// The "processes" line of /proc/stat: forks since boot. The lines before it
+// can be long (intr), so read in chunks and only look at line starts.
+bool readForks(unsigned long long& out) {
+    FILE* f = std::fopen("/proc/stat", "re");
+    if (!f) return false;
+    char buf[512];
+    bool lineStart = true;
+    bool found = false;
+    while (std::fgets(buf, sizeof(buf), f)) {
+        if (lineStart && std::strncmp(buf, "processes ", 10) == 0) {
+            out = std::strtoull(buf + 10, nullptr, 10);
+            found = true;
+            break;
+        }
+        lineStart = std::strchr(buf, '\n') != nullptr;
+    }
+    std::fclose(f);
+    return found;
+}
+
+void setEntry(Entry& e, int pid, uint32_t value, std::string_view name) {
+    e.pid = pid;
+    e.value = value;
+    std::memset(e.name, 0, sizeof(e.name));
+    size_t n = std::min(name.size(), sizeof(e.name) - 1);
+    if (n < name.size()) {
+        while (n > 0 && ((unsigned char)name[n] & 0xC0) == 0x80) --n;
+    }
+    std::memcpy(e.name, name.data(), n);
+}
+
+std::string_view nameOf(const Entry& e) {
+    return {e.name, strnlen(e.name, sizeof(e.name))};
+}
+
+// "/usr/bin/python3 -m http.server" -> "python3".
+std::string_view programOf(std::string_view name) {
+    name = name.substr(0, name.find(' '));
+    const size_t slash = name.rfind('/');
+    return slash == std::string_view::npos ? name : name.substr(slash + 1);
+}
+
+uint32_t saturate(double v) {
+    return v <= 0.0 ? 0 : v >= 4e9 ? 4'000'000'000u : (uint32_t)(v + 0.5);
+}
+
+} // namespace
+
+// --- FlightLog -------------------------------------------------------------
+
+struct FlightLog::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    uint64_t written;       // records appended so far (stored after the record)
+    char reserved[32];
+};
+
+FlightLog::~FlightLog() {
+    close();
+}
+
+bool FlightLog::open(const char* path, size_t bytes) {
+    close();
+    static_assert(sizeof(Header) == 64);
+    const size_t capacity = bytes > sizeof(Header) ? (bytes - sizeof(Header)) / sizeof(Record) : 0;
+    if (capacity == 0) {
+        errno = EINVAL;
+        return false;
+    }
+    const size_t size = sizeof(Header) + capacity * sizeof(Record);
+
+    const int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) return false;
+    // One writer per file; the lock lives as long as the descriptor.
+    if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        return false;
+    }
+    struct stat st;
+    bool fresh = ::fstat(fd, &st) != 0 || (size_t)st.st_size != size;
+    if (!fresh) {
+        Header h;
+        fresh = ::pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || std::memcmp(h.magic, kMagic, 8) != 0
+                || h.version != kVersion || h.recordSize != sizeof(Record) || h.capacity != capacity;
+    }
+    // Blocks are allocated up front: a full disk must fail here, not as a
+    // SIGBUS on a later store into the mapping.
+    if (fresh && (::ftruncate(fd, 0) != 0 || ::posix_fallocate(fd, 0, (off_t)size) != 0)) {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        return false;
+    }
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        return false;
+    }
+
+    m_header = static_cast<Header*>(map);
+    m_records = reinterpret_cast<Record*>(static_cast<char*>(map) + sizeof(Header));
+    m_capacity = capacity;
+    m_mapSize = size;
+    m_fd = fd;
+    if (fresh) {
+        std::memcpy(m_header->magic, kMagic, sizeof(kMagic));
+        m_header->version = kVersion;
+        m_header->recordSize = sizeof(Record);
+        m_header->capacity = capacity;
+        m_header->written = 0;
+    }
+    return true;
+}
+
+void FlightLog::close() {
+    if (m_header) ::munmap(m_header, m_mapSize);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_header = nullptr;
+    m_records = nullptr;
+    m_capacity = 0;
+    m_mapSize = 0;
+}
+
+unsigned long long FlightLog::written() const {
+    return m_header ? m_header->written : 0;
+}
+
+unsigned long long FlightLog::first() const {
+    const unsigned long long n = written();
+    return n > m_capacity ? n - m_capacity : 0;
+}
+
+void FlightLog::append(Record& r) {
+    if (!m_header) return;
+    const unsigned long long n = m_header->written;
+    Record& slot = m_records[n % m_capacity];
+    // seq last: a record torn by a crash does not pass read()'s check.
+    r.seq = 0;
+    std::memcpy(&slot, &r, sizeof(Record));
+    slot.seq = n + 1;
+    r.seq = n + 1;
+    m_header->written = n + 1;
+}
+
+bool FlightLog::read(unsigned long long n, Record& out) const {
+    if (!m_header || n >= written() || n < first()) return false;
+    std::memcpy(&out, &m_records[n % m_capacity], sizeof(Record));
+    return out.seq == n + 1;
+}
+
+// --- FlightRecorder --------------------------------------------------------
+
+FlightRecorder::FlightRecorder(FlightOptions options) : m_opt(std::move(options)) {
+    m_opt.budget = std::clamp(m_opt.budget, 1e-5, 1.0);
+    m_opt.minIntervalMs = std::max(m_opt.minIntervalMs, 100);
+}
+
+FlightRecorder::~FlightRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool FlightRecorder::start(std::string* error) {
+    if (m_thread.joinable()) return true;
+    if (!m_log.open(m_opt.path.c_str(), m_opt.bytes)) {
+        if (error) *error = errno == EWOULDBLOCK ? m_opt.path + " is in use by another recorder" : std::strerror(errno);
+        return false;
+    }
+    m_stats.capacity = m_log.capacity();
+    m_stats.records = (size_t)(m_log.written() - m_log.first());
+    m_started = std::chrono::steady_clock::now();
+    m_thread = std::thread([this] { run(); });
+    return true;
+}
+
+FlightRecorder::Stats FlightRecorder::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s = m_stats;
+    s.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_started).count();
+    return s;
+}
+
+void FlightRecorder::run() {
+    using Clock = std::chrono::steady_clock;
+    struct Key {
+        int pid;
+        unsigned long long startTime;
+    };
+    struct Spawn {
+        std::string_view program;
+        int pid;
+    };
+
+    ProcSampler procs;
+    SystemSampler sys;
+    ProcTable table;
+    std::vector<Key> prev;
+    std::vector<Spawn> spawned;
+    std::vector<std::pair<uint32_t, size_t>> runs;   // (count, index of the run's last spawn)
+    std::vector<uint32_t> order;
+    Record rec;
+    unsigned long long forks = 0;
+    double costNs = 0.0;                               // smoothed CPU time per sample
+
+    // Baseline for CPU % and for what counts as new; not recorded.
+    long long cpu0 = threadCpuNs();
+    procs.sample(table);
+    sys.sample();
+    readForks(forks);
+    for (size_t r = 0; r < table.size(); ++r) prev.push_back({table.pid[r], table.startTime[r]});
+    auto last = Clock::now();
+    long long spent = threadCpuNs() - cpu0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stats.cpuSeconds += (double)spent / 1e9;
+    for (;;) {
+        // Recent cost per sample over the budget gives the spacing that
+        // keeps the average within it.
+        costNs = costNs == 0.0 ? (double)spent : 0.7 * costNs + 0.3 * (double)spent;
+        const double intervalMs = std::max((double)m_opt.minIntervalMs, costNs / 1e6 / m_opt.budget);
+        m_stats.intervalMs = (int)std::min(intervalMs, 1e9);
+        if (m_cv.wait_for(lock, std::chrono::duration<double, std::milli>(intervalMs), [this] { return m_stop; })) {
+            break;
+        }
+        lock.unlock();
+
+        cpu0 = threadCpuNs();
+        procs.sample(table);
+        const SystemSnapshot s = sys.sample();
+        const auto now = Clock::now();
+        std::memset(&rec, 0, sizeof(rec));
+        rec.timeMs = wallClockMs();
+        rec.intervalMs = saturate(std::chrono::duration<double, std::milli>(now - last).count());
+        last = now;
+        rec.procs = (uint32_t)table.size();
+        unsigned long long forksNow = forks;
+        if (readForks(forksNow)) {
+            rec.forks = (uint32_t)std::min<unsigned long long>(forksNow - std::min(forks, forksNow), ~0u);
+            forks = forksNow;
+        }
+        rec.cpuCenti = saturate(s.cpuPercent * 100.0);
+        rec.memUsedMiB = saturate(s.memUsedMiB);
+
+        const ProcTable& t = table;
+        const size_t n = t.size();
+        auto top = [&](const std::vector<double>& column, Entry* out, double scale) {
+            order.resize(n);
+            for (uint32_t r = 0; r < (uint32_t)n; ++r) order[r] = r;
+            const size_t k = std::min<size_t>(kTop, n);
+            std::partial_sort(order.begin(), order.begin() + (ptrdiff_t)k, order.end(),
+                              [&](uint32_t a, uint32_t b) { return column[a] > column[b]; });
+            for (size_t i = 0; i < k && column[order[i]] > 0.0; ++i) {
+                setEntry(out[i], t.pid[order[i]], saturate(column[order[i]] * scale), t.name(order[i]));
+            }
+        };
+        top(t.cpuPercent, rec.cpu, 100.0);
+        top(t.rssMiB, rec.rss, 1024.0);
+
+        // New since the last sample: both tables are in PID order.
+        spawned.clear();
+        for (size_t r = 0, j = 0; r < n; ++r) {
+            while (j < prev.size() && prev[j].pid < t.pid[r]) ++j;
+            if (j < prev.size() && prev[j].pid == t.pid[r] && prev[j].startTime == t.startTime[r]) continue;
+            spawned.push_back({programOf(t.name(r)), t.pid[r]});
+        }
+        std::sort(spawned.begin(), spawned.end(),
+                  [](const Spawn& a, const Spawn& b) { return a.program < b.program; });
+        runs.clear();
+        for (size_t i = 0; i < spawned.size(); ++i) {
+            if (i == 0 || spawned[i].program != spawned[i - 1].program) runs.push_back({0, i});
+            ++runs.back().first;
+            runs.back().second = i;
+        }
+        const size_t k = std::min<size_t>(kTop, runs.size());
+        std::partial_sort(runs.begin(), runs.begin() + (ptrdiff_t)k, runs.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t i = 0; i < k; ++i) {
+            const Spawn& sp = spawned[runs[i].second];
+            setEntry(rec.spawns[i], sp.pid, runs[i].first, sp.program);
+        }
+
+        prev.resize(n);
+        for (size_t r = 0; r < n; ++r) prev[r] = {t.pid[r], t.startTime[r]};
+
+        lock.lock();
+        m_log.append(rec);
+        spent = threadCpuNs() - cpu0;
+        ++m_stats.samples;
+        m_stats.cpuSeconds += (double)spent / 1e9;
+        m_stats.records = (size_t)(m_log.written() - m_log.first());
+    }
+}
+
+FlightSummary FlightRecorder::summarize(int minutes, size_t top) const {
+    FlightSummary out;
+    std::map<std::pair<int, std::string>, double> cpu;     // CPU % x ms
+    std::map<std::pair<int, std::string>, uint32_t> rss;   // peak KiB
+    std::map<std::string, std::pair<unsigned long long, int>, std::less<>> spawns;
+    double windowMs = 0.0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const long long from = wallClockMs() - (long long)minutes * 60'000;
+        Record rec;
+        for (unsigned long long n = m_log.written(); n > m_log.first(); --n) {
+            if (!m_log.read(n - 1, rec)) continue;
+            if (rec.timeMs < from) break;
+            if (out.samples == 0) out.toMs = rec.timeMs;
+            out.fromMs = rec.timeMs;
+            ++out.samples;
+            out.forks += rec.forks;
+            windowMs += rec.intervalMs;
+            for (const Entry& e : rec.cpu) {
+                if (e.pid) cpu[{e.pid, std::string(nameOf(e))}] += e.value / 100.0 * rec.intervalMs;
+            }
+            for (const Entry& e : rec.rss) {
+                if (!e.pid) continue;
+                uint32_t& peak = rss[{e.pid, std::string(nameOf(e))}];
+                peak = std::max(peak, e.value);
+            }
+            for (const Entry& e : rec.spawns) {
+                if (!e.pid) continue;
+                auto& [count, pid] = spawns[std::string(nameOf(e))];
+                if (count == 0) pid = e.pid;   // records go newest first
+                count += e.value;
+            }
+        }
+    }
+
+    auto finish = [top](std::vector<FlightSummary::Item>& items) {
+        const size_t k = std::min(top, items.size());
+        std::partial_sort(items.begin(), items.begin() + (ptrdiff_t)k, items.end(),
+                          [](const auto& a, const auto& b) { return a.value > b.value; });
+        items.resize(k);
+    };
+    for (const auto& [key, sum] : cpu) out.cpu.push_back({key.second, key.first, windowMs > 0 ? sum / windowMs : 0.0});
+    for (const auto& [key, peak] : rss) out.rss.push_back({key.second, key.first, peak / 1024.0});
+    for (const auto& [name, v] : spawns) out.spawns.push_back({name, v.second, (double)v.first});
+    finish(out.cpu);
+    finish(out.rss);
+    finish(out.spawns);
+    return out;
+}
+
+} // namespace FrogKill
@@ -0,0 +1,148 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FrogKill {
+
+namespace FlightFormat {
+
+constexpr int kTop = 8;
+
+struct Entry {
+    int32_t pid;
+    uint32_t value;         // CPU: hundredths of %; RSS: KiB; spawns: count
+    char name[40];          // NUL-padded, cut at a UTF-8 boundary
+};
+
+// One sample: the system totals and the top processes of each kind.
+struct Record {
+    uint64_t seq;           // 1 + position in the write order; 0 = unused
+    int64_t timeMs;         // wall clock (ms since the epoch)
+    uint32_t intervalMs;    // since the previous record
+    uint32_t procs;
+    uint32_t forks;         // processes the kernel created in the interval
+    uint32_t cpuCenti;      // system CPU, hundredths of %
+    uint32_t memUsedMiB;
+    uint32_t reserved;
+    Entry cpu[kTop];        // highest CPU first
+    Entry rss[kTop];        // largest RSS first
+    Entry spawns[kTop];     // programs with the most new processes (pid: newest)
+};
+
+} // namespace FlightFormat
+
+// Fixed-size circular file of FlightFormat::Record, memory-mapped. A 64-byte
+// header (magic, geometry, records written so far) is followed by the
+// slots; record n goes to slot n % capacity(). Reopening a log of the same
+// geometry continues it, so history survives a restart. Not thread-safe.
+class FlightLog {
+public:
+    FlightLog() = default;
+    ~FlightLog();
+    FlightLog(const FlightLog&) = delete;
+    FlightLog& operator=(const FlightLog&) = delete;
+
+    // Opens or creates `path` at `bytes` (rounded down to whole records).
+    // False with errno set on failure (EWOULDBLOCK: another process has it
+    // open).
+    bool open(const char* path, size_t bytes);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    size_t capacity() const { return m_capacity; }
+    unsigned long long written() const;
+    // Oldest record number still in the file.
+    unsigned long long first() const;
+
+    // Stamps `r.seq` and stores it over the oldest record.
+    void append(FlightFormat::Record& r);
+    // Record number `n`; false if it was overwritten or never written.
+    bool read(unsigned long long n, FlightFormat::Record& out) const;
+
+private:
+    struct Header;
+
+    Header* m_header{nullptr};
+    FlightFormat::Record* m_records{nullptr};
+    size_t m_capacity{0};
+    size_t m_mapSize{0};
+    int m_fd{-1};           // held for the flock()
+};
+
+// What the log says about a recent time window (see FlightRecorder::summarize()).
+struct FlightSummary {
+    struct Item {
+        std::string name;
+        int pid;                // spawns: the newest process
+        double value;
+    };
+
+    long long fromMs{0};        // first and last sample in the window
+    long long toMs{0};
+    size_t samples{0};
+    unsigned long long forks{0};
+    std::vector<Item> cpu;      // mean CPU % over the window
+    std::vector<Item> rss;      // peak RSS, MiB
+    std::vector<Item> spawns;   // processes started, by program
+};
+
+// Always-on background sampler for the daemon: records the top processes
+// into a FlightLog so that, after a freeze, the window can show what was
+// running even if the culprit is gone.
+//
+// The thread measures its own CPU time (sampling and writing) and spaces
+// samples so that it stays within `budget` of one core on average: the
+// interval is the recent cost per sample divided by the budget, and never
+// shorter than `minIntervalMs`.
+struct FlightOptions {
+    std::string path;
+    size_t bytes{4u << 20};
+    double budget{0.001};       // fraction of one core (0.001 = 0.1%)
+    int minIntervalMs{2000};
+};
+
+class FlightRecorder {
+public:
+    explicit FlightRecorder(FlightOptions options);
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Opens the log and starts sampling. On failure `error` gets a reason.
+    bool start(std::string* error = nullptr);
+
+    struct Stats {
+        unsigned long long samples{0};
+        double cpuSeconds{0.0};     // spent by the recorder since start()
+        double wallSeconds{0.0};
+        int intervalMs{0};          // current spacing of samples
+        size_t records{0};          // in the log (including earlier runs)
+        size_t capacity{0};
+    };
+    Stats stats() const;
+    const FlightOptions& options() const { return m_opt; }
+
+    // Top `top` of each list over the last `minutes`.
+    FlightSummary summarize(int minutes, size_t top) const;
+
+private:
+    void run();
+
+    FlightOptions m_opt;
+    FlightLog m_log;
+
+    mutable std::mutex m_mutex;                 // m_log, m_stats, m_stop
+    std::condition_variable m_cv;
+    bool m_stop{false};
+    Stats m_stats;
+    std::chrono::steady_clock::time_point m_started;
+    std::thread m_thread;
+};
+
+} // namespace FrogKill
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+namespace FrogKill {
+
+// Wire format of `frogkill-helper --session` (Qt-free; shared by the helper
+// and the GUI). The session talks over the helper's stdin/stdout, which
+// pkexec hands through unchanged.
+//
+// Every frame is a native-endian uint32 payload length followed by the
+// payload (both ends run on the same machine). A request is a Request,
+// followed for KillBatch by `count` BatchEntry records; a frame of any
+// other length ends the session. Replies carry the helper's exit code,
+// one code per batch entry and the diagnostic text.
+namespace HelperProto {
+
+constexpr uint32_t kVersion = 1;
+// Most PIDs in one batch (also the limit of `frogkill-helper --pids`).
+constexpr uint32_t kMaxBatch = 4096;
+// Upper bound for any frame; larger lengths are a protocol error.
+constexpr uint32_t kMaxFrame = 128 * 1024;
+
+enum class Op : uint32_t {
+    Kill = 1,
+    Quit = 2,
+    KillBatch = 3,     // `count` PIDs, each on its own (Process scope)
+};
+
+enum class Scope : uint32_t {
+    Process = 0,
+    Tree = 1,
+    Cgroup = 2,        // the cgroup of `pid`, resolved by the helper
+};
+
+struct Request {
+    uint32_t version;
+    Op op;
+    int32_t pid;
+    int32_t sig;               // SIGTERM or SIGKILL only
+    uint64_t startTime;        // 0 = don't check the generation
+    int32_t graceMs;           // 0..600000
+    Scope scope;
+    uint32_t count;            // BatchEntry records that follow (KillBatch only)
+};
+
+struct BatchEntry {
+    int32_t pid;
+    uint32_t reserved;         // must be 0
+    uint64_t startTime;        // 0 = don't check the generation
+};
+
+// Followed by `count` int32 per-entry codes, then the (non-terminated)
+// diagnostic text, if any.
+struct ReplyHeader {
+    uint32_t version;
+    int32_t code;              // same values as the helper's exit status
+    uint32_t count;
+};
+
+} // namespace HelperProto
+
+} // namespace FrogKill
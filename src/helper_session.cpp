@@ -0,0 +1,165 @@
+#include "helper_session.h"
+
+#include <QDeadlineTimer>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstring>
+
+namespace FrogKill {
+
+// Once authenticated, a reply may take the request's grace period plus the
+// helper's own freeze/kill waits; anything beyond this means it is stuck.
+static constexpr int kReplySlackMs = 30000;
+// How often a wait for the password checks for cancellation.
+static constexpr int kCancelPollMs = 100;
+
+HelperSession::HelperSession(const QString& helperPath, int idleTimeoutSec)
+    : m_helperPath(helperPath), m_idleTimeoutSec(idleTimeoutSec) {
+    m_proc.setProcessChannelMode(QProcess::SeparateChannels);
+}
+
+HelperSession::~HelperSession() {
+    stop();
+}
+
+bool HelperSession::start(QString& output) {
+    m_in.clear();
+    m_authenticated = false;
+    m_proc.setProgram("pkexec");
+    m_proc.setArguments(QStringList{} << "--disable-internal-agent"
+                                      << m_helperPath
+                                      << "--session"
+                                      << "--idle-timeout" << QString::number(m_idleTimeoutSec));
+    m_proc.start();
+    if (!m_proc.waitForStarted()) {
+        output = "Falha ao executar pkexec.";
+        return false;
+    }
+    return true;
+}
+
+void HelperSession::stop() {
+    if (!isRunning()) return;
+    // The helper runs as root, so it cannot be killed from here: ask it to
+    // quit, and closing stdin makes it exit anyway.
+    HelperProto::Request req{};
+    req.version = HelperProto::kVersion;
+    req.op = HelperProto::Op::Quit;
+    const uint32_t len = sizeof(req);
+    m_proc.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    m_proc.write(reinterpret_cast<const char*>(&req), sizeof(req));
+    m_proc.closeWriteChannel();
+    // pkexec still waiting for polkit does not read stdin; it runs with our
+    // real uid until it execs the helper, so it can be killed.
+    if (!m_proc.waitForFinished(1000)) m_proc.kill();
+}
+
+int HelperSession::kill(int pid, unsigned long long startTime, int sig, int graceMs,
+                        HelperProto::Scope scope, QString& output, const std::atomic<bool>* cancel) {
+    HelperProto::Request req{};
+    req.version = HelperProto::kVersion;
+    req.op = HelperProto::Op::Kill;
+    req.pid = pid;
+    req.sig = sig;
+    req.startTime = startTime;
+    req.graceMs = graceMs;
+    req.scope = scope;
+    std::vector<int> codes;
+    return transact(req, nullptr, codes, output, cancel);
+}
+
+int HelperSession::killBatch(const std::vector<HelperProto::BatchEntry>& entries, int sig, int graceMs,
+                             std::vector<int>& codes, QString& output, const std::atomic<bool>* cancel) {
+    HelperProto::Request req{};
+    req.version = HelperProto::kVersion;
+    req.op = HelperProto::Op::KillBatch;
+    req.sig = sig;
+    req.graceMs = graceMs;
+    req.scope = HelperProto::Scope::Process;
+    req.count = (uint32_t)entries.size();
+    return transact(req, &entries, codes, output, cancel);
+}
+
+int HelperSession::transact(const HelperProto::Request& req, const std::vector<HelperProto::BatchEntry>* entries,
+                            std::vector<int>& codes, QString& output, const std::atomic<bool>* cancel) {
+    QByteArray frame;
+    const size_t entryBytes = entries ? entries->size() * sizeof(HelperProto::BatchEntry) : 0;
+    const uint32_t len = (uint32_t)(sizeof(req) + entryBytes);
+    frame.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    frame.append(reinterpret_cast<const char*>(&req), sizeof(req));
+    if (entryBytes > 0) frame.append(reinterpret_cast<const char*>(entries->data()), (qsizetype)entryBytes);
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const bool fresh = !isRunning();
+        if (fresh && !start(output)) return -1;
+        m_proc.write(frame);
+
+        // Until the first reply the helper may still be waiting for polkit.
+        const int code = readReply(m_authenticated ? req.graceMs + kReplySlackMs : -1, codes, output, cancel);
+        if (code >= 0) return code;
+        // An established session may just have hit its idle timeout: retry
+        // once with a new one. A fresh one failed for real (prompt dismissed,
+        // not authorized, ...).
+        if (fresh || isRunning()) break;
+    }
+    stop();
+    return -1;
+}
+
+int HelperSession::readReply(int timeoutMs, std::vector<int>& codes, QString& output,
+                             const std::atomic<bool>* cancel) {
+    QDeadlineTimer deadline(timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeoutMs));
+    for (;;) {
+        m_in.append(m_proc.readAllStandardOutput());
+        if (m_in.size() >= (qsizetype)sizeof(uint32_t)) {
+            uint32_t len = 0;
+            std::memcpy(&len, m_in.constData(), sizeof(len));
+            if (len < sizeof(HelperProto::ReplyHeader) || len > HelperProto::kMaxFrame) {
+                output = "Resposta inválida do helper.";
+                return -1;
+            }
+            if (m_in.size() >= (qsizetype)(sizeof(len) + len)) {
+                HelperProto::ReplyHeader header{};
+                const char* p = m_in.constData() + sizeof(len);
+                std::memcpy(&header, p, sizeof(header));
+                const size_t codesBytes = (size_t)header.count * sizeof(int32_t);
+                if (header.version != HelperProto::kVersion || sizeof(header) + codesBytes > len) {
+                    output = "Resposta inválida do helper.";
+                    return -1;
+                }
+                codes.resize(header.count);
+                if (codesBytes > 0) std::memcpy(codes.data(), p + sizeof(header), codesBytes);
+                const char* text = p + sizeof(header) + codesBytes;
+                output = QString::fromLocal8Bit(text, (qsizetype)(len - sizeof(header) - codesBytes)).trimmed();
+                m_in.remove(0, (qsizetype)(sizeof(len) + len));
+                m_authenticated = true;
+                return header.code;
+            }
+        }
+
+        if (!isRunning()) {
+            output = QString::fromLocal8Bit(m_proc.readAllStandardError()).trimmed();
+            if (output.isEmpty()) {
+                output = QString("pkexec terminou com código %1.").arg(m_proc.exitCode());
+            }
+            return -1;
+        }
+        const qint64 left = deadline.remainingTime();
+        if (left == 0) {
+            output = "O helper não respondeu.";
+            return -1;
+        }
+        if (m_authenticated || !cancel) {
+            m_proc.waitForReadyRead(left < 0 ? -1 : (int)left);
+            continue;
+        }
+        if (cancel->load(std::memory_order_relaxed)) {
+            output = "Cancelado.";
+            return -1;
+        }
+        m_proc.waitForReadyRead(left < 0 ? kCancelPollMs : (int)std::min<qint64>(left, kCancelPollMs));
+    }
+}
+
+} // namespace FrogKill
@@ -0,0 +1,63 @@
+#pragma once
+#include <QByteArray>
+#include <QProcess>
+#include <QString>
+
+#include <atomic>
+#include <vector>
+
+#include "helper_protocol.h"
+
+namespace FrogKill {
+
+// Opt-in elevated session: one pkexec launch of `frogkill-helper --session`
+// that stays alive until it has been idle for idleTimeoutSec, so later
+// elevated kills are a pipe round-trip instead of a password prompt and a
+// fork/exec/polkit cycle each. The helper applies the same checks as on
+// the command line (PID > 1, TERM/KILL only).
+//
+// The blocking calls must all come from one thread (the one that created
+// the session), which need not be the GUI thread.
+class HelperSession {
+public:
+    HelperSession(const QString& helperPath, int idleTimeoutSec);
+    ~HelperSession();
+
+    HelperSession(const HelperSession&) = delete;
+    HelperSession& operator=(const HelperSession&) = delete;
+
+    bool isRunning() const { return m_proc.state() == QProcess::Running; }
+    int idleTimeoutSec() const { return m_idleTimeoutSec; }
+
+    // Sends one kill request, starting (and authenticating) the session on
+    // demand. Returns the helper's exit code for the request, or -1 if the
+    // session could not be used; `output` receives the diagnostics.
+    // Setting `cancel` abandons a session that is still waiting for the
+    // password; an authenticated request always runs to completion.
+    int kill(int pid, unsigned long long startTime, int sig, int graceMs, HelperProto::Scope scope,
+             QString& output, const std::atomic<bool>* cancel = nullptr);
+    // Same for a batch of single processes (at most kMaxBatch); `codes`
+    // receives one status per entry.
+    int killBatch(const std::vector<HelperProto::BatchEntry>& entries, int sig, int graceMs,
+                  std::vector<int>& codes, QString& output, const std::atomic<bool>* cancel = nullptr);
+
+    // Asks the helper to exit (it also exits on its own when idle).
+    void stop();
+
+private:
+    bool start(QString& output);
+    // Sends one request frame and returns the reply code (see kill()).
+    int transact(const HelperProto::Request& req, const std::vector<HelperProto::BatchEntry>* entries,
+                 std::vector<int>& codes, QString& output, const std::atomic<bool>* cancel);
+    // Waits for one complete reply frame; -1 if the session died, timed out
+    // or was cancelled before authenticating.
+    int readReply(int timeoutMs, std::vector<int>& codes, QString& output, const std::atomic<bool>* cancel);
+
+    QString m_helperPath;
+    int m_idleTimeoutSec;
+    QProcess m_proc;
+    QByteArray m_in;
+    bool m_authenticated{false};   // a reply has been received since start()
+};
+
+} // namespace FrogKill
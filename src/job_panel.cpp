@@ -0,0 +1,221 @@
+#include "job_panel.h"
+#include "kill_jobs.h"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QTimer>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace FrogKill {
+
+// Progress refresh while a job runs (the worker only bumps a counter).
+static constexpr int kTickMs = 100;
+// A job that went fine disappears on its own after this long.
+static constexpr int kAutoDismissMs = 5000;
+
+using Outcome = KillJobs::Outcome;
+using State = KillJobs::State;
+
+static QString outcomeText(const KillJobs::Job& job, size_t i) {
+    switch (job.outcomes[i]) {
+    case Outcome::Pending: return "pendente";
+    case Outcome::Signalled: return "sinal enviado";
+    case Outcome::Gone: return "já terminou";
+    case Outcome::Blocked: return job.kind == KillJobs::Kind::Processes ? "bloqueado (PID <= 1)" : "bloqueado";
+    case Outcome::Denied: return "sem permissão";
+    case Outcome::Failed: return job.errors[i].isEmpty() ? QString("falhou") : "falhou: " + job.errors[i];
+    case Outcome::StillRunning: return "ainda em execução";
+    case Outcome::Cancelled: return "cancelado";
+    }
+    return {};
+}
+
+static size_t countOf(const KillJobs::Job& job, Outcome o) {
+    return (size_t)std::count(job.outcomes.begin(), job.outcomes.end(), o);
+}
+
+// True if the result needs the user's attention (kept until dismissed).
+static bool hasProblems(const KillJobs::Job& job) {
+    if (job.state == State::Cancelled) return true;
+    for (const Outcome o : job.outcomes) {
+        if (o != Outcome::Signalled && o != Outcome::Gone) return true;
+    }
+    return false;
+}
+
+static QString summary(const KillJobs::Job& job) {
+    const size_t total = job.targets.size();
+    if (job.state == State::Running) {
+        if (job.kind != KillJobs::Kind::Processes) return "congelando e sinalizando…";
+        return QString("%1 de %2…").arg(job.progress.load(std::memory_order_relaxed)).arg(total);
+    }
+    if (job.state == State::NeedsElevation) {
+        if (job.kind == KillJobs::Kind::Tree) return "sem permissão para toda a árvore.";
+        if (job.kind == KillJobs::Kind::Cgroup) return "sem permissão para o cgroup.";
+        return QString("sem permissão para %1 processos.").arg(countOf(job, Outcome::Denied));
+    }
+    if (job.state == State::Elevating) return "aguardando o administrador…";
+
+    if (job.kind != KillJobs::Kind::Processes) {
+        const Outcome o = job.outcomes.front();
+        if (o == Outcome::Signalled && job.members > 0) return QString("%1 processos sinalizados.").arg(job.members);
+        return outcomeText(job, 0) + ".";
+    }
+    if (total == 1) return outcomeText(job, 0) + ".";
+    const size_t done = countOf(job, Outcome::Signalled);
+    const size_t gone = countOf(job, Outcome::Gone);
+    return QString("%1 sinalizados, %2 já tinham terminado, %3 com problemas.")
+        .arg(done).arg(gone).arg(total - done - gone);
+}
+
+JobPanel::JobPanel(KillJobs* jobs, QWidget* parent) : QFrame(parent), m_jobs(jobs) {
+    setObjectName("Jobs");
+    m_layout = new QVBoxLayout(this);
+    m_layout->setContentsMargins(6, 4, 6, 4);
+    m_layout->setSpacing(2);
+    hide();
+
+    m_tick = new QTimer(this);
+    m_tick->setInterval(kTickMs);
+    connect(m_tick, &QTimer::timeout, this, &JobPanel::updateProgress);
+
+    connect(m_jobs, &KillJobs::stateChanged, this, &JobPanel::refreshJob);
+}
+
+JobPanel::Row& JobPanel::rowFor(int id) {
+    auto it = m_rows.find(id);
+    if (it != m_rows.end()) return it->second;
+
+    Row row;
+    row.widget = new QWidget(this);
+    auto* layout = new QHBoxLayout(row.widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    row.text = new QLabel(row.widget);
+    row.text->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(row.text, 1);
+
+    row.bar = new QProgressBar(row.widget);
+    row.bar->setMaximumWidth(160);
+    row.bar->setMaximumHeight(14);
+    row.bar->setTextVisible(false);
+    layout->addWidget(row.bar);
+
+    row.elevate = new QPushButton("Executar como administrador", row.widget);
+    connect(row.elevate, &QPushButton::clicked, this, [this, id] { m_jobs->elevate(id); });
+    layout->addWidget(row.elevate);
+
+    row.cancel = new QToolButton(row.widget);
+    row.cancel->setText("Cancelar");
+    connect(row.cancel, &QToolButton::clicked, this, [this, id] { m_jobs->cancel(id); });
+    layout->addWidget(row.cancel);
+
+    row.details = new QToolButton(row.widget);
+    row.details->setText("Detalhes");
+    connect(row.details, &QToolButton::clicked, this, [this, id] { showDetails(id); });
+    layout->addWidget(row.details);
+
+    row.close = new QToolButton(row.widget);
+    row.close->setText("×");
+    row.close->setToolTip("Fechar");
+    connect(row.close, &QToolButton::clicked, this, [this, id] { dismiss(id); });
+    layout->addWidget(row.close);
+
+    m_layout->addWidget(row.widget);
+    show();
+    return m_rows.emplace(id, row).first->second;
+}
+
+void JobPanel::refreshJob(int id) {
+    const KillJobs::Job* job = m_jobs->job(id);
+    if (!job) return;
+    Row& row = rowFor(id);
+
+    const bool finished = job->state == State::Done || job->state == State::Cancelled;
+    const bool busy = job->state == State::Running || job->state == State::Elevating;
+
+    row.text->setText(QString("%1 — %2").arg(job->title, summary(*job)));
+    if (finished && !job->message.isEmpty()) row.text->setToolTip(job->message);
+
+    row.bar->setVisible(busy);
+    if (job->state == State::Running && job->kind == KillJobs::Kind::Processes) {
+        row.bar->setRange(0, (int)job->targets.size());
+        row.bar->setValue((int)job->progress.load(std::memory_order_relaxed));
+    } else {
+        row.bar->setRange(0, 0);   // busy indicator
+    }
+
+    row.elevate->setVisible(job->state == State::NeedsElevation);
+    row.cancel->setVisible(!finished);
+    row.cancel->setEnabled(!job->cancel.load());
+    row.cancel->setText(job->state == State::NeedsElevation ? "Ignorar" : "Cancelar");
+    row.details->setVisible(finished && (job->targets.size() > 1 || hasProblems(*job) || !job->message.isEmpty()));
+    row.close->setVisible(finished);
+
+    if (finished && !hasProblems(*job)) {
+        QTimer::singleShot(kAutoDismissMs, this, [this, id] { dismiss(id); });
+    }
+
+    bool running = false;
+    for (const auto& [rowId, r] : m_rows) {
+        const KillJobs::Job* j = m_jobs->job(rowId);
+        if (j && j->state == State::Running) running = true;
+    }
+    if (running) m_tick->start();
+    else m_tick->stop();
+}
+
+void JobPanel::updateProgress() {
+    for (const auto& [id, row] : m_rows) {
+        const KillJobs::Job* job = m_jobs->job(id);
+        if (!job || job->state != State::Running) continue;
+        row.text->setText(QString("%1 — %2").arg(job->title, summary(*job)));
+        if (job->kind == KillJobs::Kind::Processes) {
+            row.bar->setValue((int)job->progress.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+void JobPanel::showDetails(int id) {
+    const KillJobs::Job* job = m_jobs->job(id);
+    if (!job) return;
+
+    QString details;
+    if (job->kind == KillJobs::Kind::Processes) {
+        for (size_t i = 0; i < job->targets.size(); ++i) {
+            const KillTarget& t = job->targets[i];
+            details += QString("%1 (PID %2): %3\n").arg(t.name).arg(t.pid).arg(outcomeText(*job, i));
+        }
+    } else {
+        const KillTarget& t = job->targets.front();
+        details = QString("%1 (PID %2): %3\n").arg(t.name).arg(t.pid).arg(outcomeText(*job, 0));
+    }
+    if (!job->message.isEmpty()) details += "\n" + job->message + "\n";
+
+    // Non-modal: the table keeps updating while it is open.
+    auto* box = new QMessageBox(QMessageBox::Information, "Resultado", job->title, QMessageBox::Ok, window());
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->setInformativeText(summary(*job));
+    box->setDetailedText(details);
+    box->open();
+}
+
+void JobPanel::dismiss(int id) {
+    const auto it = m_rows.find(id);
+    if (it == m_rows.end()) return;
+    const KillJobs::Job* job = m_jobs->job(id);
+    if (job && job->state != State::Done && job->state != State::Cancelled) return;
+
+    it->second.widget->deleteLater();
+    m_rows.erase(it);
+    m_jobs->remove(id);
+    if (m_rows.empty()) hide();
+}
+
+} // namespace FrogKill
@@ -0,0 +1,48 @@
+#pragma once
+#include <QFrame>
+
+#include <unordered_map>
+
+class QLabel;
+class QProgressBar;
+class QPushButton;
+class QTimer;
+class QToolButton;
+class QVBoxLayout;
+
+namespace FrogKill {
+
+class KillJobs;
+
+// Non-modal status area for kill jobs: one line per job with its progress,
+// a cancel button, the elevation prompt when some targets need root and
+// the per-PID results once it is done. Hidden while there are no jobs.
+class JobPanel : public QFrame {
+    Q_OBJECT
+public:
+    explicit JobPanel(KillJobs* jobs, QWidget* parent = nullptr);
+
+private:
+    struct Row {
+        QWidget* widget{nullptr};
+        QLabel* text{nullptr};
+        QProgressBar* bar{nullptr};
+        QPushButton* elevate{nullptr};
+        QToolButton* cancel{nullptr};
+        QToolButton* details{nullptr};
+        QToolButton* close{nullptr};
+    };
+
+    void refreshJob(int id);
+    void updateProgress();
+    void showDetails(int id);
+    void dismiss(int id);
+    Row& rowFor(int id);
+
+    KillJobs* m_jobs;
+    QVBoxLayout* m_layout{nullptr};
+    QTimer* m_tick{nullptr};
+    std::unordered_map<int, Row> m_rows;   // by job id
+};
+
+} // namespace FrogKill
@@ -0,0 +1,385 @@
+#include "kill_jobs.h"
+#include "helper_protocol.h"
+#include "helper_session.h"
+#include "kill_watcher.h"
+#include "tree_kill.h"
+
+#include <QProcess>
+#include <QStringList>
+
+#include <signal.h>
+#include <errno.h>
+#include <cstring>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace FrogKill {
+
+// Direct jobs mostly sleep (sweep passes, the TERM grace period); a few
+// threads are plenty.
+static constexpr int kDirectThreads = 4;
+// How often a one-shot pkexec run checks for cancellation.
+static constexpr int kCancelPollMs = 100;
+
+static QString sigArg(int sig) {
+    return sig == SIGKILL ? QStringLiteral("KILL") : QStringLiteral("TERM");
+}
+
+static QString errnoText(int e) {
+    return QString::fromLocal8Bit(std::strerror(e));
+}
+
+// Helper status (see frogkill-helper) -> outcome.
+static KillJobs::Outcome fromHelperCode(int code) {
+    switch (code) {
+    case 0: return KillJobs::Outcome::Signalled;
+    case 3: return KillJobs::Outcome::Gone;
+    case 5: return KillJobs::Outcome::StillRunning;
+    default: return KillJobs::Outcome::Failed;
+    }
+}
+
+// Runs pkexec to completion. Cancelling kills it, which works until it
+// has authenticated and exec'd the helper as root; from then on the
+// request runs to completion. True if pkexec exited normally.
+static bool runPkexec(QProcess& p, const QStringList& args, const std::atomic<bool>& cancel) {
+    p.setProgram("pkexec");
+    p.setArguments(args);
+    p.start();
+    if (!p.waitForStarted()) return false;
+    for (;;) {
+        if (p.waitForFinished(kCancelPollMs) || p.state() == QProcess::NotRunning) break;
+        if (cancel.load(std::memory_order_relaxed)) {
+            p.kill();
+            p.waitForFinished(-1);
+            break;
+        }
+    }
+    return p.exitStatus() == QProcess::NormalExit;
+}
+
+KillJobs::KillJobs(KillWatcher* watcher, QObject* parent) : QObject(parent), m_watcher(watcher) {
+    m_pool.setMaxThreadCount(kDirectThreads);
+    // The helper session's QProcess belongs to the thread that created it:
+    // keep that one thread alive for good.
+    m_elevatedPool.setMaxThreadCount(1);
+    m_elevatedPool.setExpiryTimeout(-1);
+}
+
+KillJobs::~KillJobs() {
+    for (auto& [id, job] : m_jobs) job->cancel.store(true);
+    m_pool.waitForDone();
+    m_elevatedPool.start([this] { m_session.reset(); });
+    m_elevatedPool.waitForDone();
+}
+
+const KillJobs::Job* KillJobs::job(int id) const {
+    const auto it = m_jobs.find(id);
+    return it == m_jobs.end() ? nullptr : it->second.get();
+}
+
+int KillJobs::start(Kind kind, int sig, std::vector<KillTarget> targets, const QString& title) {
+    auto job = std::make_shared<Job>();
+    job->id = m_nextId++;
+    job->kind = kind;
+    job->sig = sig;
+    job->graceMs = sig == SIGTERM ? m_watcher->graceMs() : 0;
+    job->title = title;
+    job->targets = std::move(targets);
+    job->outcomes.assign(job->targets.size(), Outcome::Pending);
+    job->errors.resize(job->targets.size());
+    m_jobs[job->id] = job;
+
+    const int id = job->id;
+    m_pool.start([this, job] {
+        runDirect(*job);
+        QMetaObject::invokeMethod(this, [this, id = job->id] { directDone(id); }, Qt::QueuedConnection);
+    });
+    emit stateChanged(id);
+    return id;
+}
+
+void KillJobs::runDirect(Job& job) {
+    if (job.kind == Kind::Processes) {
+        job.handles.resize(job.targets.size());
+        for (size_t i = 0; i < job.targets.size(); ++i) {
+            if (job.cancel.load(std::memory_order_relaxed)) {
+                std::fill(job.outcomes.begin() + (std::ptrdiff_t)i, job.outcomes.end(), Outcome::Cancelled);
+                break;
+            }
+            const KillTarget& t = job.targets[i];
+            if (t.pid <= 1) {
+                job.outcomes[i] = Outcome::Blocked;
+            } else {
+                // Bound to the sampled generation: a PID reused since then is skipped.
+                ProcHandle& handle = job.handles[i];
+                int e = handle.open(t.pid, t.startTime);
+                if (e == 0) e = handle.signal(job.sig);
+                if (e == 0) {
+                    job.outcomes[i] = Outcome::Signalled;
+                } else if (e == ESRCH) {
+                    job.outcomes[i] = Outcome::Gone;
+                } else if (e == EPERM) {
+                    job.outcomes[i] = Outcome::Denied;
+                } else {
+                    job.outcomes[i] = Outcome::Failed;
+                    job.errors[i] = errnoText(e);
+                }
+            }
+            job.progress.store(i + 1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    // The tree is frozen before it is signalled, so a fork loop cannot
+    // outrun the kill. TERM escalation happens here too, on this worker:
+    // killTree()/killCgroup() freeze again before the SIGKILL, which also
+    // catches children forked during the grace period.
+    const KillTarget& root = job.targets.front();
+    TreeKillOptions opts;
+    opts.sig = job.sig;
+    opts.graceMs = job.graceMs;
+    opts.cancel = &job.cancel;
+    TreeKillResult r;
+    if (job.kind == Kind::Tree) {
+        r = killTree(root.pid, root.startTime, opts);
+    } else {
+        std::string path;
+        r = killCgroup(root.pid, root.startTime, opts, path);
+        job.message = QString::fromStdString(path);
+    }
+    job.handles = std::move(r.members);
+    job.members = r.signalled;
+    job.progress.store(1, std::memory_order_relaxed);
+
+    Outcome& outcome = job.outcomes.front();
+    if (r.error == ECANCELED) {
+        outcome = Outcome::Cancelled;
+    } else if (r.error == EPERM) {
+        outcome = Outcome::Denied;
+    } else if (r.error == EINVAL || r.error == EDEADLK) {
+        outcome = Outcome::Blocked;
+    } else if (r.error != 0) {
+        outcome = Outcome::Failed;
+        job.errors.front() = errnoText(r.error);
+    } else if (job.handles.empty()) {
+        outcome = Outcome::Gone;
+    } else {
+        outcome = Outcome::Signalled;
+        if (job.kind == Kind::Tree && !r.converged) {
+            job.message = QString("A árvore continuou crescendo; %1 processos sinalizados.").arg(r.signalled);
+        }
+    }
+}
+
+void KillJobs::directDone(int id) {
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    Job& job = *it->second;
+
+    // Watch what we signalled ourselves; keep the handles of Denied
+    // processes for after the elevation. Trees and cgroups were already
+    // escalated by the job itself.
+    const bool escalate = job.sig == SIGTERM;
+    if (job.kind == Kind::Processes) {
+        for (size_t i = 0; i < job.handles.size(); ++i) {
+            if (job.outcomes[i] == Outcome::Signalled) {
+                m_watcher->watch(std::move(job.handles[i]), escalate);
+            } else if (job.outcomes[i] != Outcome::Denied) {
+                job.handles[i].close();
+            }
+        }
+    } else {
+        for (auto& handle : job.handles) m_watcher->watch(std::move(handle), /*escalate=*/false);
+        job.handles.clear();
+    }
+
+    const bool denied = std::find(job.outcomes.begin(), job.outcomes.end(), Outcome::Denied) != job.outcomes.end();
+    if (denied && !job.cancel.load()) {
+        job.state = State::NeedsElevation;
+        emit stateChanged(id);
+        return;
+    }
+    finish(job);
+}
+
+void KillJobs::elevate(int id) {
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end() || it->second->state != State::NeedsElevation) return;
+    std::shared_ptr<Job> job = it->second;
+    job->state = State::Elevating;
+    m_elevatedPool.start([this, job] {
+        runElevated(*job);
+        QMetaObject::invokeMethod(this, [this, id = job->id] { elevatedDone(id); }, Qt::QueuedConnection);
+    });
+    emit stateChanged(id);
+}
+
+HelperSession* KillJobs::session() {
+    const int sec = m_sessionSec.load();
+    if (sec <= 0) {
+        m_session.reset();
+        return nullptr;
+    }
+    if (!m_session || m_session->idleTimeoutSec() != sec) {
+        m_session = std::make_unique<HelperSession>(QStringLiteral(FROGKILL_HELPER_PATH), sec);
+    }
+    return m_session.get();
+}
+
+void KillJobs::runElevated(Job& job) {
+    HelperSession* s = session();
+
+    if (job.kind != Kind::Processes) {
+        // One request for the whole tree/cgroup; the helper resolves (and
+        // validates) the members itself and does the TERM -> KILL escalation.
+        const KillTarget& root = job.targets.front();
+        const auto scope = job.kind == Kind::Tree ? HelperProto::Scope::Tree : HelperProto::Scope::Cgroup;
+        QString out;
+        int code = -1;
+        if (s) {
+            // Only the first request of a session prompts for the password.
+            code = s->kill(root.pid, root.startTime, job.sig, job.graceMs, scope, out, &job.cancel);
+        } else {
+            QStringList args;
+            args << "--disable-internal-agent"
+                 << QStringLiteral(FROGKILL_HELPER_PATH)
+                 << "--pid" << QString::number(root.pid)
+                 << "--sig" << sigArg(job.sig);
+            if (root.startTime != 0) args << "--start-time" << QString::number(root.startTime);
+            if (job.graceMs > 0) args << "--grace" << QString::number(job.graceMs);
+            args << (scope == HelperProto::Scope::Tree ? "--tree" : "--cgroup");
+            QProcess p;
+            p.setProcessChannelMode(QProcess::MergedChannels);
+            if (runPkexec(p, args, job.cancel)) code = p.exitCode();
+            out = QString::fromLocal8Bit(p.readAll()).trimmed();
+        }
+        if (code < 0) {
+            job.message = job.cancel.load() ? QStringLiteral("Cancelado.") : out;
+            return;
+        }
+        job.outcomes.front() = fromHelperCode(code);
+        if (code != 0) job.errors.front() = QString("helper retornou código %1").arg(code);
+        if (!out.isEmpty()) job.message = out;
+        return;
+    }
+
+    std::vector<size_t> denied;
+    for (size_t i = 0; i < job.targets.size(); ++i) {
+        if (job.outcomes[i] == Outcome::Denied) denied.push_back(i);
+    }
+    // One round-trip per kMaxBatch targets.
+    for (size_t begin = 0; begin < denied.size(); begin += HelperProto::kMaxBatch) {
+        if (job.cancel.load()) return;
+        const size_t end = std::min(denied.size(), begin + (size_t)HelperProto::kMaxBatch);
+        std::vector<int> codes(end - begin, -1);
+        QString out;
+
+        if (s) {
+            std::vector<HelperProto::BatchEntry> entries;
+            entries.reserve(end - begin);
+            for (size_t k = begin; k < end; ++k) {
+                const KillTarget& t = job.targets[denied[k]];
+                entries.push_back({t.pid, 0, t.startTime});
+            }
+            std::vector<int> reply;
+            if (s->killBatch(entries, job.sig, job.graceMs, reply, out, &job.cancel) < 0
+                || reply.size() != entries.size()) {
+                job.message = job.cancel.load() ? QStringLiteral("Cancelado.") : out;
+                return;
+            }
+            codes = std::move(reply);
+        } else {
+            // The helper prints "<pid> <status>" per target.
+            QStringList list;
+            for (size_t k = begin; k < end; ++k) {
+                const KillTarget& t = job.targets[denied[k]];
+                list << QString("%1:%2").arg(t.pid).arg(t.startTime);
+            }
+            QStringList args;
+            args << "--disable-internal-agent"
+                 << QStringLiteral(FROGKILL_HELPER_PATH)
+                 << "--pids" << list.join(',')
+                 << "--sig" << sigArg(job.sig);
+            if (job.graceMs > 0) args << "--grace" << QString::number(job.graceMs);
+            QProcess p;
+            const bool ran = runPkexec(p, args, job.cancel);
+            out = QString::fromLocal8Bit(p.readAllStandardError()).trimmed();
+
+            std::unordered_map<int, int> byPid;
+            const auto lines = QString::fromLocal8Bit(p.readAllStandardOutput()).split('\n', Qt::SkipEmptyParts);
+            for (const auto& line : lines) {
+                const auto parts = line.split(' ');
+                if (parts.size() == 2) byPid[parts[0].toInt()] = parts[1].toInt();
+            }
+            // pkexec itself failed (prompt dismissed, not authorized, ...).
+            if (!ran || byPid.empty()) {
+                job.message = job.cancel.load() ? QStringLiteral("Cancelado.") : out;
+                return;
+            }
+            for (size_t k = begin; k < end; ++k) {
+                const auto hit = byPid.find(job.targets[denied[k]].pid);
+                if (hit != byPid.end()) codes[k - begin] = hit->second;
+            }
+        }
+
+        for (size_t k = begin; k < end; ++k) {
+            const int code = codes[k - begin];
+            job.outcomes[denied[k]] = fromHelperCode(code);
+            if (job.outcomes[denied[k]] == Outcome::Failed) {
+                job.errors[denied[k]] = QString("helper retornou código %1").arg(code);
+            }
+        }
+        if (!out.isEmpty()) job.message = out;
+    }
+}
+
+void KillJobs::elevatedDone(int id) {
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    Job& job = *it->second;
+
+    // The helper did the signalling (and escalation); we can still watch
+    // for the exits to refresh right away.
+    for (size_t i = 0; i < job.handles.size(); ++i) {
+        if (job.outcomes[i] == Outcome::Signalled && job.handles[i].isOpen()) {
+            m_watcher->watch(std::move(job.handles[i]), /*escalate=*/false);
+        }
+    }
+    job.handles.clear();
+    finish(job);
+}
+
+void KillJobs::cancel(int id) {
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    Job& job = *it->second;
+    job.cancel.store(true);
+    if (job.state == State::NeedsElevation) {
+        job.handles.clear();
+        finish(job);
+        return;
+    }
+    emit stateChanged(id);
+}
+
+void KillJobs::finish(Job& job) {
+    // A cancel that came too late to stop anything does not count.
+    const bool stopped = std::any_of(job.outcomes.begin(), job.outcomes.end(), [](Outcome o) {
+        return o == Outcome::Cancelled || o == Outcome::Denied || o == Outcome::Pending;
+    });
+    job.state = job.cancel.load() && stopped ? State::Cancelled : State::Done;
+    const int id = job.id;
+    emit stateChanged(id);
+    emit finished(id);
+}
+
+void KillJobs::remove(int id) {
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    const State st = it->second->state;
+    if (st == State::Done || st == State::Cancelled) m_jobs.erase(it);
+}
+
+} // namespace FrogKill
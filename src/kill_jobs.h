@@ -0,0 +1,114 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "proc_kill.h"
+
+namespace FrogKill {
+
+class HelperSession;
+class KillWatcher;
+
+// A process as listed in the table, bound to the generation it had when
+// it was sampled.
+struct KillTarget {
+    int pid{0};
+    unsigned long long startTime{0};
+    QString name;
+};
+
+// Kill actions as background jobs, so the window (table, refresh, input)
+// stays live while a tree is frozen, a large batch is signalled or pkexec
+// waits for the password. Direct signalling runs on a small thread pool,
+// so several jobs progress side by side; elevated requests are serialized
+// on one thread, which also owns the helper session. Jobs change state and
+// emit signals on the GUI thread only.
+class KillJobs : public QObject {
+    Q_OBJECT
+public:
+    enum class Kind { Processes, Tree, Cgroup };
+
+    enum class State {
+        Running,            // direct signalling
+        NeedsElevation,     // some targets need root: elevate() or cancel()
+        Elevating,          // pkexec / helper round-trip
+        Done,
+        Cancelled,
+    };
+
+    // Per target (Tree and Cgroup have a single target, the root).
+    enum class Outcome { Pending, Signalled, Gone, Blocked, Denied, Failed, StillRunning, Cancelled };
+
+    struct Job {
+        int id{0};
+        Kind kind{Kind::Processes};
+        int sig{0};
+        int graceMs{0};             // TERM -> KILL escalation of trees, cgroups and the helper
+        QString title;
+        std::vector<KillTarget> targets;
+
+        // Owned by the GUI thread while no phase runs.
+        State state{State::Running};
+        std::vector<Outcome> outcomes;
+        std::vector<QString> errors;        // diagnostics of Failed targets
+        size_t members{0};                  // Tree/Cgroup: processes signalled
+        QString message;                    // helper output / phase summary
+        // Per target (Processes) or the tree/cgroup members; the GUI thread
+        // hands them to the watcher.
+        std::vector<ProcHandle> handles;
+
+        // Shared with the running phase.
+        std::atomic<size_t> progress{0};    // targets handled so far
+        std::atomic<bool> cancel{false};
+    };
+
+    explicit KillJobs(KillWatcher* watcher, QObject* parent = nullptr);
+    ~KillJobs() override;
+
+    // Keep one elevated helper session alive for this long when idle
+    // (0 = one pkexec per elevated request).
+    void setElevatedSessionSec(int sec) { m_sessionSec.store(sec); }
+
+    // Queues a job and returns its id. Tree and Cgroup take one target.
+    int start(Kind kind, int sig, std::vector<KillTarget> targets, const QString& title);
+    // Sends the Denied targets of a NeedsElevation job to the helper.
+    void elevate(int id);
+    // Stops a running job before its next target or sweep pass (a tree
+    // not signalled yet is resumed), or declines a pending elevation.
+    void cancel(int id);
+    // Forgets a finished job.
+    void remove(int id);
+
+    const Job* job(int id) const;
+
+signals:
+    void stateChanged(int id);
+    // The job reached Done or Cancelled.
+    void finished(int id);
+
+private:
+    void runDirect(Job& job);
+    void runElevated(Job& job);
+    void directDone(int id);
+    void elevatedDone(int id);
+    void finish(Job& job);
+    // Elevated thread only.
+    HelperSession* session();
+
+    KillWatcher* m_watcher;
+    std::unordered_map<int, std::shared_ptr<Job>> m_jobs;
+    int m_nextId{1};
+
+    QThreadPool m_pool;
+    QThreadPool m_elevatedPool;
+    std::atomic<int> m_sessionSec{0};
+    std::unique_ptr<HelperSession> m_session;
+};
+
+} // namespace FrogKill
@@ -0,0 +1,91 @@
+#include "kill_watcher.h"
+
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <signal.h>
+
+namespace FrogKill {
+
+// Give up on a process that ignores SIGTERM (no escalation) or survives
+// SIGKILL (stuck in D state) after this long.
+static constexpr int kWatchLimitMs = 30000;
+// Exit polling interval when the kernel has no pidfd support.
+static constexpr int kFallbackPollMs = 100;
+
+struct KillWatcher::Entry {
+    ProcHandle handle;
+    bool escalate{false};
+    QSocketNotifier* notifier{nullptr};
+    QTimer* poll{nullptr};
+    QTimer* timer{nullptr};
+
+    // Entries are dropped from inside these objects' own signals, so they
+    // are deleted later; the notifier is disabled before the fd closes.
+    ~Entry() {
+        if (notifier) {
+            notifier->setEnabled(false);
+            notifier->deleteLater();
+        }
+        if (poll) {
+            poll->stop();
+            poll->deleteLater();
+        }
+        timer->stop();
+        timer->deleteLater();
+    }
+};
+
+KillWatcher::KillWatcher(QObject* parent) : QObject(parent) {}
+
+KillWatcher::~KillWatcher() = default;
+
+void KillWatcher::watch(ProcHandle handle, bool escalate) {
+    const int pid = handle.pid();
+    if (pid <= 0) return;
+
+    auto e = std::make_unique<Entry>();
+    e->handle = std::move(handle);
+    e->escalate = escalate && m_graceMs > 0;
+
+    if (e->handle.fd() >= 0) {
+        e->notifier = new QSocketNotifier((qintptr)e->handle.fd(), QSocketNotifier::Read);
+        connect(e->notifier, &QSocketNotifier::activated, this, [this, pid] { check(pid); });
+    } else {
+        e->poll = new QTimer();
+        connect(e->poll, &QTimer::timeout, this, [this, pid] { check(pid); });
+        e->poll->start(kFallbackPollMs);
+    }
+    e->timer = new QTimer();
+    e->timer->setSingleShot(true);
+    connect(e->timer, &QTimer::timeout, this, [this, pid] { timeout(pid); });
+    e->timer->start(e->escalate ? m_graceMs : kWatchLimitMs);
+
+    // A repeated kill of the same PID replaces the older entry.
+    m_entries[pid] = std::move(e);
+    check(pid);
+}
+
+void KillWatcher::check(int pid) {
+    auto it = m_entries.find(pid);
+    if (it == m_entries.end() || !it->second->handle.exited()) return;
+    // Erase first: a slot connected to exited() may call watch() again.
+    m_entries.erase(it);
+    emit exited(pid);
+}
+
+void KillWatcher::timeout(int pid) {
+    auto it = m_entries.find(pid);
+    if (it == m_entries.end()) return;
+    Entry& e = *it->second;
+    if (!e.escalate) {
+        m_entries.erase(it);
+        return;
+    }
+    e.escalate = false;
+    const int err = e.handle.signal(SIGKILL);
+    e.timer->start(kWatchLimitMs);
+    emit escalated(pid, err);
+}
+
+} // namespace FrogKill
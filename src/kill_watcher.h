@@ -0,0 +1,46 @@
+#pragma once
+#include <QObject>
+
+#include <memory>
+#include <unordered_map>
+
+#include "proc_kill.h"
+
+class QSocketNotifier;
+class QTimer;
+
+namespace FrogKill {
+
+// Follows processes we have signalled. exited() fires as soon as one is gone
+// (QSocketNotifier on its pidfd, or a short poll without pidfd support), so
+// the view can refresh right away. With escalation armed, a process still
+// running after the grace period gets SIGKILL through the same handle.
+class KillWatcher : public QObject {
+    Q_OBJECT
+public:
+    explicit KillWatcher(QObject* parent = nullptr);
+    ~KillWatcher() override;
+
+    // SIGTERM -> SIGKILL grace period; 0 disables escalation.
+    void setGraceMs(int ms) { m_graceMs = ms; }
+    int graceMs() const { return m_graceMs; }
+
+    // Takes over `handle`. `escalate` arms the SIGKILL timer (for a SIGTERM
+    // we sent ourselves).
+    void watch(ProcHandle handle, bool escalate);
+
+signals:
+    void exited(int pid);
+    // SIGKILL sent after the grace period; `error` is 0 or an errno value.
+    void escalated(int pid, int error);
+
+private:
+    struct Entry;
+    void check(int pid);
+    void timeout(int pid);
+
+    int m_graceMs{5000};
+    std::unordered_map<int, std::unique_ptr<Entry>> m_entries;   // by pid
+};
+
+} // namespace FrogKill
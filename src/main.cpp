@@ -2,8 +2,18 @@
 #include <QCommandLineParser>
 #include <QStyleFactory>
 #include "app_controller.h"
+#include "batch_mode.h"
+
+#include <algorithm>
+#include <cstring>
 
 int main(int argc, char** argv) {
+    // Headless mode is dispatched before any QApplication exists: no
+    // display connection, style or stylesheet to pay for.
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0) return FrogKill::runBatch(argc, argv);
+    }
+
     QApplication app(argc, argv);
     QApplication::setApplicationName("FrogKill");
     QApplication::setOrganizationName("FrogTools");
@@ -35,15 +45,104 @@ int main(int argc, char** argv) {
     QCommandLineOption optDaemon(QStringList{} << "d" << "daemon", "Run in background and listen for toggle commands.");
     QCommandLineOption optToggle(QStringList{} << "t" << "toggle", "Toggle/raise the FrogKill window (IPC to running daemon).");
     QCommandLineOption optNoSingle(QStringList{} << "no-single-instance", "Disable single-instance behavior (debug only).");
+    QCommandLineOption optScanThreads(QStringList{} << "scan-threads",
+                                      "Threads used to scan /proc (default 1; 0 = one per CPU).", "N", "1");
+    QCommandLineOption optProcEvents(QStringList{} << "proc-events",
+                                     "Track processes via the kernel proc connector instead of rescanning /proc (needs CAP_NET_ADMIN).");
+    QCommandLineOption optKillGrace(QStringList{} << "kill-grace-ms",
+                                    "Send SIGKILL if a process is still running this long after SIGTERM (default 5000; 0 = never).",
+                                    "MS", "5000");
+    QCommandLineOption optElevatedSession(QStringList{} << "elevated-session",
+                                          "Keep the privileged helper running between elevated actions until idle for SECONDS "
+                                          "(1..3600; default 0 = one pkexec prompt per action).",
+                                          "SECONDS", "0");
+    QCommandLineOption optRefresh(QStringList{} << "refresh-ms",
+                                  "Process table refresh interval (default 1000).", "MS", "1000");
+    QCommandLineOption optHeaderRefresh(QStringList{} << "header-ms",
+                                        "Refresh interval of the CPU/RAM header (default 500).", "MS", "500");
+    QCommandLineOption optRefreshBudget(QStringList{} << "refresh-budget",
+                                        "Refresh the table less often when scanning would use more than PERCENT "
+                                        "of one core (default 10; 0 = never).",
+                                        "PERCENT", "10");
+    QCommandLineOption optHistory(QStringList{} << "history-mb",
+                                  "Memory for the per-process CPU/RAM history column (default 8; 0 = hide it).",
+                                  "MIB", "8");
+    QCommandLineOption optRecord(QStringList{} << "record",
+                                 "Record every snapshot to FILE while the window is open (see --replay).", "FILE");
+    QCommandLineOption optReplay(QStringList{} << "replay",
+                                 "Browse a recording made with --record instead of the live system.", "FILE");
+    QCommandLineOption optFlight(QStringList{} << "flight-recorder",
+                                 "Keep sampling the top processes in the background into a small circular file, "
+                                 "so the window can show the last minutes (meant for --daemon).");
+    QCommandLineOption optFlightMb(QStringList{} << "flight-mb",
+                                   "Size of the flight recorder file (default 4).", "MIB", "4");
+    QCommandLineOption optFlightBudget(QStringList{} << "flight-budget",
+                                       "CPU the flight recorder may use, in percent of one core (default 0.1).",
+                                       "PERCENT", "0.1");
+    // Handled above; listed here for --help.
+    QCommandLineOption optBatch(QStringList{} << "batch",
+                                "Print process snapshots to stdout without a GUI (see --batch --help).");
 
     parser.addOption(optDaemon);
     parser.addOption(optToggle);
     parser.addOption(optNoSingle);
+    parser.addOption(optScanThreads);
+    parser.addOption(optProcEvents);
+    parser.addOption(optKillGrace);
+    parser.addOption(optElevatedSession);
+    parser.addOption(optRefresh);
+    parser.addOption(optHeaderRefresh);
+    parser.addOption(optRefreshBudget);
+    parser.addOption(optHistory);
+    parser.addOption(optRecord);
+    parser.addOption(optReplay);
+    parser.addOption(optFlight);
+    parser.addOption(optFlightMb);
+    parser.addOption(optFlightBudget);
+    parser.addOption(optBatch);
 
     parser.process(app);
 
     FrogKill::AppController controller;
     controller.setSingleInstanceEnabled(!parser.isSet(optNoSingle));
+    bool threadsOk = false;
+    const int scanThreads = parser.value(optScanThreads).toInt(&threadsOk);
+    controller.setScanThreads(threadsOk ? scanThreads : 1);
+    controller.setProcEvents(parser.isSet(optProcEvents));
+    bool graceOk = false;
+    const int killGraceMs = parser.value(optKillGrace).toInt(&graceOk);
+    controller.setKillGraceMs(graceOk && killGraceMs >= 0 ? killGraceMs : 5000);
+    bool sessionOk = false;
+    const int sessionSec = parser.value(optElevatedSession).toInt(&sessionOk);
+    controller.setElevatedSessionSec(sessionOk ? std::clamp(sessionSec, 0, 3600) : 0);
+    bool refreshOk = false, headerOk = false;
+    const int refreshMs = parser.value(optRefresh).toInt(&refreshOk);
+    const int headerMs = parser.value(optHeaderRefresh).toInt(&headerOk);
+    controller.setRefreshIntervals(refreshOk ? std::clamp(refreshMs, 100, 60000) : 1000,
+                                   headerOk ? std::clamp(headerMs, 100, 60000) : 500);
+    bool refreshBudgetOk = false;
+    const double refreshBudget = parser.value(optRefreshBudget).toDouble(&refreshBudgetOk);
+    controller.setRefreshBudget(refreshBudgetOk ? std::clamp(refreshBudget, 0.0, 100.0) / 100.0 : 0.10);
+    bool historyOk = false;
+    const int historyMiB = parser.value(optHistory).toInt(&historyOk);
+    if (historyOk) controller.setHistoryMiB(std::clamp(historyMiB, 0, 4096));
+    if (parser.isSet(optRecord)) controller.setRecordPath(parser.value(optRecord));
+    FrogKill::FlightOptions flight;
+    bool flightMbOk = false;
+    const int flightMb = parser.value(optFlightMb).toInt(&flightMbOk);
+    if (flightMbOk) flight.bytes = (size_t)std::clamp(flightMb, 1, 1024) << 20;
+    bool budgetOk = false;
+    const double budget = parser.value(optFlightBudget).toDouble(&budgetOk);
+    if (budgetOk) flight.budget = std::clamp(budget, 0.001, 100.0) / 100.0;
+    controller.setFlightOptions(flight);
+
+    if (parser.isSet(optReplay)) {
+        // A viewer of its own, next to any running instance.
+        controller.setSingleInstanceEnabled(false);
+        if (!controller.openReplay(parser.value(optReplay))) return 1;
+        controller.showWindow();
+        return app.exec();
+    }
 
     if (parser.isSet(optToggle)) {
         // Try to toggle an existing instance; if none is running, fall back to starting normally.
@@ -52,12 +151,14 @@ int main(int argc, char** argv) {
         }
         // No running instance. Start GUI directly.
         controller.startServer();
+        if (parser.isSet(optFlight)) controller.startFlightRecorder();
         controller.showWindow();
         return app.exec();
     }
 
     if (parser.isSet(optDaemon)) {
         controller.startServer();
+        if (parser.isSet(optFlight)) controller.startFlightRecorder();
         // Daemon mode: keep a tray icon so the user can toggle quickly.
         controller.ensureTray();
         // No window yet; waits for toggle.
@@ -66,6 +167,7 @@ int main(int argc, char** argv) {
 
     // Default: show GUI (and still be single-instance capable)
     controller.startServer();
+    if (parser.isSet(optFlight)) controller.startFlightRecorder();
     controller.showWindow();
     return app.exec();
 }
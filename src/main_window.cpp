@@ -1,14 +1,35 @@
 #include "main_window.h"
+#include "flight_dialog.h"
+#include "job_panel.h"
+#include "kill_jobs.h"
+#include "kill_watcher.h"
+#include "proc_filter.h"
+#include "proc_history.h"
+#include "process_filter_proxy.h"
 #include "process_model.h"
-#include "system_sampler.h"
+#include "process_tree_model.h"
+#include "sampler_thread.h"
+#include "snapshot.h"
+#include "snapshot_file.h"
+#include "sparkline_delegate.h"
+#include "thread_model.h"
+#include "tree_kill.h"
 #include "util.h"
 
+#include <QComboBox>
+#include <QFile>
+#include <QFileInfo>
+#include <QSlider>
 #include <QTableView>
+#include <QTimer>
+#include <QTreeView>
+#include <QStackedWidget>
+#include <QSplitter>
+#include <QItemSelectionModel>
 #include <QLineEdit>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QTimer>
 #include <QPushButton>
 #include <QHeaderView>
 #include <QMessageBox>
@@ -18,25 +39,29 @@
 #include <QToolButton>
 #include <QFrame>
 #include <QMenu>
-#include <QProcess>
 #include <QApplication>
 #include <QStyle>
 #include <QStatusBar>
-#include <QRegularExpression>
 #include <QScreen>
 #include <QDateTime>
 #include <QCoreApplication>
+#include <QWindow>
 
 #include <signal.h>
 #include <errno.h>
 #include <cstring>
 
 #include <algorithm>
-#include <unordered_map>
 #include <vector>
 
 namespace FrogKill {
 
+// Samples per process in the history column (one per tick).
+static constexpr unsigned kHistorySamples = 60;
+static constexpr int kDefaultHistoryMiB = 8;
+// Table and header interval in turbo mode.
+static constexpr int kTurboMs = 250;
+
 static QString sigName(int sig) {
     if (sig == SIGTERM) return "TERM";
     if (sig == SIGKILL) return "KILL";
@@ -47,18 +72,44 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     setWindowTitle("FrogKill");
     resize(860, 520);
 
+    m_killWatcher = new KillWatcher(this);
+    m_jobs = new KillJobs(m_killWatcher, this);
+
     setupActions();
     setupUi();
     setupShortcuts();
     applyViewTuning();
 
-    // Refresh timer (only runs while the window is visible)
-    m_timer = new QTimer(this);
-    m_timer->setInterval(1000);
-    connect(m_timer, &QTimer::timeout, this, &MainWindow::refreshNow);
+    // Sampler thread (only runs while the window is visible). The GUI thread
+    // just picks up the latest snapshot when notified.
+    m_sampler = std::make_unique<SamplerThread>([this] {
+        QMetaObject::invokeMethod(this, &MainWindow::applySnapshot, Qt::QueuedConnection);
+    });
+    m_sampler->setIntervalMs(m_refreshMs);
+    m_sampler->setHeaderIntervalMs(m_headerMs);
+    m_sampler->setBudget(m_refreshBudget);
+
+    // Refresh as soon as a signalled process is actually gone.
+    connect(m_killWatcher, &KillWatcher::exited, this, &MainWindow::refreshNow);
+    connect(m_jobs, &KillJobs::finished, this, &MainWindow::refreshNow);
+    connect(m_killWatcher, &KillWatcher::escalated, this, [this](int pid, int error) {
+        if (error == 0) {
+            statusBar()->showMessage(QString("PID %1 não respondeu ao SIGTERM; SIGKILL enviado.").arg(pid), 4000);
+        } else if (error != ESRCH) {
+            statusBar()->showMessage(QString("PID %1 não respondeu ao SIGTERM; SIGKILL falhou: %2")
+                                         .arg(pid).arg(QString::fromLocal8Bit(std::strerror(error))), 4000);
+        }
+    });
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    m_sampler.reset();
+    m_model->setSnapshot(nullptr);
+    m_treeModel->setSnapshot(nullptr);
+    m_threadModel->setSnapshot(nullptr);
+    // Replay frames belong to m_replayFrames.
+    if (!m_replay) delete m_front;
+}
 
 static QLabel* makeChip(QWidget* parent, const QString& text) {
     auto* l = new QLabel(text, parent);
@@ -96,6 +147,12 @@ void MainWindow::setupUi() {
 
     m_filter = new QLineEdit(this);
     m_filter->setPlaceholderText("Filtrar (nome, PID, usuário)...");
+    m_filter->setToolTip("Termos separados por espaço, todos precisam casar:\n"
+                         "  texto — nome, PID ou usuário contém\n"
+                         "  name:texto  user:texto\n"
+                         "  pid:1234  ppid:1  pid>1000\n"
+                         "  cpu>50  cpu<=1\n"
+                         "  rss>1G  rss<512M (KiB/MiB/GiB)");
     m_filter->setClearButtonEnabled(true);
     m_filter->setMaximumWidth(360);
     // Leading search icon (pure UI, negligible cost)
@@ -111,17 +168,44 @@ void MainWindow::setupUi() {
     m_toolbar->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
     m_toolbar->setIconSize(QSize(18, 18));
     m_toolbar->addAction(m_actRefresh);
+    m_toolbar->addAction(m_actTurbo);
+    m_toolbar->addAction(m_actTreeView);
+    m_toolbar->addAction(m_actThreads);
+    m_toolbar->addAction(m_actFlight);
     m_toolbar->addSeparator();
     m_toolbar->addAction(m_actKill);
     m_toolbar->addAction(m_actForce);
     m_toolbar->addSeparator();
     m_toolbar->addAction(m_actKillTree);
     m_toolbar->addAction(m_actForceTree);
+    m_toolbar->addAction(m_actKillCgroup);
     root->addWidget(m_toolbar);
 
+    // Replay controls (only with --replay).
+    m_replayBar = new QFrame(this);
+    auto* replayLayout = new QHBoxLayout(m_replayBar);
+    replayLayout->setContentsMargins(6, 0, 6, 0);
+    m_replayPlay = new QToolButton(m_replayBar);
+    m_replayPlay->setCheckable(true);
+    m_replayPlay->setIcon(style()->standardIcon(QStyle::SP_MediaPlay));
+    m_replayPlay->setToolTip("Reproduzir/pausar a gravação");
+    replayLayout->addWidget(m_replayPlay);
+    m_replaySlider = new QSlider(Qt::Horizontal, m_replayBar);
+    replayLayout->addWidget(m_replaySlider, 1);
+    m_replayTime = new QLabel(m_replayBar);
+    replayLayout->addWidget(m_replayTime);
+    m_replaySpeed = new QComboBox(m_replayBar);
+    for (const int speed : {1, 10, 60, 600}) m_replaySpeed->addItem(QString("%1×").arg(speed), speed);
+    m_replaySpeed->setToolTip("Velocidade da reprodução");
+    replayLayout->addWidget(m_replaySpeed);
+    m_replayTimer = new QTimer(this);
+    m_replayTimer->setSingleShot(true);
+    m_replayBar->hide();
+    root->addWidget(m_replayBar);
+
     m_table = new QTableView(this);
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_table->setSortingEnabled(true);
     m_table->setAlternatingRowColors(true);
     m_table->horizontalHeader()->setStretchLastSection(true);
@@ -137,38 +221,115 @@ void MainWindow::setupUi() {
     m_table->setTextElideMode(Qt::ElideRight);
 
     m_model = new ProcessModel(this);
-    m_proxy = new QSortFilterProxyModel(this);
+    m_history = std::make_unique<ProcHistory>();
+    m_history->configure((size_t)kDefaultHistoryMiB << 20, kHistorySamples);
+    m_table->setItemDelegateForColumn(5, new SparklineDelegate(m_history.get(), this));
+    m_procFilter = std::make_unique<ProcFilter>();
+    m_proxy = new ProcessFilterProxy(m_procFilter.get(), this);
     m_proxy->setSourceModel(m_model);
-    m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    m_proxy->setFilterKeyColumn(-1);
+    m_proxy->setSortInSource(true);
 
     m_table->setModel(m_proxy);
-    root->addWidget(m_table, 1);
+    // The model ignores a sort on the history column; put the indicator back.
+    connect(m_table->horizontalHeader(), &QHeaderView::sortIndicatorChanged, this, [this](int section) {
+        if (section != 5) return;
+        const QSignalBlocker block(m_table->horizontalHeader());
+        m_table->horizontalHeader()->setSortIndicator(m_model->sortColumn(), m_model->sortOrder());
+    });
+
+    m_tree = new QTreeView(this);
+    m_tree->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tree->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_tree->setSortingEnabled(true);
+    m_tree->sortByColumn(1, Qt::AscendingOrder);
+    m_tree->setAlternatingRowColors(true);
+    m_tree->setUniformRowHeights(true);
+    m_tree->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_tree->setWordWrap(false);
+    m_tree->setTextElideMode(Qt::ElideRight);
+    m_tree->header()->setStretchLastSection(true);
+
+    m_treeModel = new ProcessTreeModel(this);
+    m_treeProxy = new ProcessFilterProxy(m_procFilter.get(), this);
+    m_treeProxy->setSourceModel(m_treeModel);
+    // A match keeps its ancestors visible.
+    m_treeProxy->setRecursiveFilteringEnabled(true);
+    m_tree->setModel(m_treeProxy);
+
+    m_views = new QStackedWidget(this);
+    m_views->addWidget(m_table);
+    m_views->addWidget(m_tree);
+
+    m_threadView = new QTableView(this);
+    m_threadView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_threadView->setSortingEnabled(true);
+    m_threadView->sortByColumn(4, Qt::DescendingOrder);
+    m_threadView->setAlternatingRowColors(true);
+    m_threadView->horizontalHeader()->setStretchLastSection(true);
+    m_threadView->verticalHeader()->setVisible(false);
+    m_threadView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_threadView->verticalHeader()->setDefaultSectionSize(22);
+    m_threadView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_threadView->setShowGrid(false);
+    m_threadView->setWordWrap(false);
+
+    m_threadModel = new ThreadModel(this);
+    auto* threadProxy = new QSortFilterProxyModel(this);
+    threadProxy->setSourceModel(m_threadModel);
+    threadProxy->setSortRole(SortRole);
+    m_threadView->setModel(threadProxy);
+    m_threadView->hide();
+
+    m_splitter = new QSplitter(Qt::Vertical, this);
+    m_splitter->addWidget(m_views);
+    m_splitter->addWidget(m_threadView);
+    m_splitter->setStretchFactor(0, 3);
+    m_splitter->setStretchFactor(1, 1);
+    root->addWidget(m_splitter, 1);
+
+    m_jobPanel = new JobPanel(m_jobs, this);
+    root->addWidget(m_jobPanel);
 
     // Status bar (bottom)
     statusBar()->showMessage("Pronto.");
 
     setCentralWidget(central);
 
-    connect(m_filter, &QLineEdit::textChanged, this, [this](const QString& s){
-        // substring match across all columns
-        m_proxy->setFilterRegularExpression(QRegularExpression(QRegularExpression::escape(s),
-                                                              QRegularExpression::CaseInsensitiveOption));
-    });
+    connect(m_replaySlider, &QSlider::valueChanged, this, &MainWindow::showReplayFrame);
+    connect(m_replayPlay, &QToolButton::toggled, this, &MainWindow::setReplayPlaying);
+    connect(m_replayTimer, &QTimer::timeout, this, &MainWindow::replayStep);
 
-    // Context menu
-    m_table->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(m_table, &QWidget::customContextMenuRequested, this, [this](const QPoint& pos){
-        QMenu menu(this);
-        menu.addAction(m_actRefresh);
-        menu.addSeparator();
-        menu.addAction(m_actKill);
-        menu.addAction(m_actForce);
-        menu.addSeparator();
-        menu.addAction(m_actKillTree);
-        menu.addAction(m_actForceTree);
-        menu.exec(m_table->viewport()->mapToGlobal(pos));
+    connect(m_filter, &QLineEdit::textChanged, this, [this](const QString& s) {
+        if (m_procFilter->setQuery(s.toStdString())) applyFilter();
     });
+
+    // Context menu; the thread panel follows the selection.
+    for (QAbstractItemView* view : {static_cast<QAbstractItemView*>(m_table), static_cast<QAbstractItemView*>(m_tree)}) {
+        connect(view->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::updateTaskPids);
+        connect(view->selectionModel(), &QItemSelectionModel::currentChanged, this, &MainWindow::updateTaskPids);
+        view->setContextMenuPolicy(Qt::CustomContextMenu);
+        connect(view, &QWidget::customContextMenuRequested, this, [this, view](const QPoint& pos) {
+            showContextMenu(view, pos);
+        });
+    }
+}
+
+void MainWindow::showContextMenu(QAbstractItemView* view, const QPoint& pos) {
+    QMenu menu(this);
+    menu.addAction(m_actRefresh);
+    menu.addAction(m_actTurbo);
+    menu.addAction(m_actSelectAll);
+    menu.addAction(m_actTreeView);
+    menu.addAction(m_actThreads);
+    if (m_flight) menu.addAction(m_actFlight);
+    menu.addSeparator();
+    menu.addAction(m_actKill);
+    menu.addAction(m_actForce);
+    menu.addSeparator();
+    menu.addAction(m_actKillTree);
+    menu.addAction(m_actForceTree);
+    menu.addAction(m_actKillCgroup);
+    menu.exec(view->viewport()->mapToGlobal(pos));
 }
 
 void MainWindow::applyViewTuning() {
@@ -178,7 +339,13 @@ void MainWindow::applyViewTuning() {
     m_table->setColumnWidth(2, 90);   // CPU
     m_table->setColumnWidth(3, 110);  // RAM
     m_table->setColumnWidth(4, 140);  // User
+    m_table->setColumnWidth(5, 140);  // History
     // Name (col 1) stays flexible.
+
+    m_tree->setColumnWidth(0, 300);   // Name (indented)
+    m_tree->setColumnWidth(1, 80);    // PID
+    m_tree->setColumnWidth(2, 90);    // CPU
+    m_tree->setColumnWidth(3, 110);   // RAM
 }
 
 void MainWindow::setupActions() {
@@ -189,6 +356,49 @@ void MainWindow::setupActions() {
     addAction(m_actRefresh);
     connect(m_actRefresh, &QAction::triggered, this, &MainWindow::refreshNow);
 
+    m_actTurbo = new QAction("Turbo", this);
+    m_actTurbo->setToolTip(QString("Atualizar a cada %1 ms, sem limite de CPU").arg(kTurboMs));
+    m_actTurbo->setCheckable(true);
+    m_actTurbo->setShortcut(QKeySequence("Ctrl+Shift+T"));
+    m_actTurbo->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_actTurbo->setIcon(style()->standardIcon(QStyle::SP_MediaSeekForward));
+    addAction(m_actTurbo);
+    connect(m_actTurbo, &QAction::toggled, this, &MainWindow::setTurbo);
+
+    m_actSelectAll = new QAction("Selecionar todos (filtro)", this);
+    m_actSelectAll->setShortcut(QKeySequence::SelectAll);
+    m_actSelectAll->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    addAction(m_actSelectAll);
+    connect(m_actSelectAll, &QAction::triggered, this, &MainWindow::selectAllFiltered);
+
+    m_actTreeView = new QAction("Hierarquia", this);
+    m_actTreeView->setToolTip("Mostrar os processos em árvore (CPU e RAM somam os descendentes)");
+    m_actTreeView->setCheckable(true);
+    m_actTreeView->setShortcut(QKeySequence("Ctrl+T"));
+    m_actTreeView->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_actTreeView->setIcon(style()->standardIcon(QStyle::SP_FileDialogDetailedView));
+    addAction(m_actTreeView);
+    connect(m_actTreeView, &QAction::toggled, this, &MainWindow::setTreeMode);
+
+    m_actThreads = new QAction("Threads", this);
+    m_actThreads->setToolTip("Mostrar as threads dos processos selecionados (CPU por thread)");
+    m_actThreads->setCheckable(true);
+    m_actThreads->setShortcut(QKeySequence("Ctrl+H"));
+    m_actThreads->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_actThreads->setIcon(style()->standardIcon(QStyle::SP_FileDialogListView));
+    addAction(m_actThreads);
+    connect(m_actThreads, &QAction::toggled, this, &MainWindow::setThreadsVisible);
+
+    m_actFlight = new QAction("Últimos minutos…", this);
+    m_actFlight->setToolTip("O que o gravador em segundo plano registrou (mais CPU, mais RAM, mais processos criados)");
+    m_actFlight->setShortcut(QKeySequence("Ctrl+L"));
+    m_actFlight->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_actFlight->setIcon(style()->standardIcon(QStyle::SP_FileDialogInfoView));
+    m_actFlight->setVisible(false);
+    m_actFlight->setEnabled(false);
+    addAction(m_actFlight);
+    connect(m_actFlight, &QAction::triggered, this, &MainWindow::showFlightLog);
+
     m_actKill = new QAction("Finalizar", this);
     m_actKill->setShortcut(QKeySequence::Delete);
     m_actKill->setShortcutContext(Qt::WidgetWithChildrenShortcut);
@@ -216,6 +426,12 @@ void MainWindow::setupActions() {
     m_actForceTree->setIcon(style()->standardIcon(QStyle::SP_TrashIcon));
     addAction(m_actForceTree);
     connect(m_actForceTree, &QAction::triggered, this, &MainWindow::killSelectedTreeKill);
+
+    m_actKillCgroup = new QAction("Forçar cgroup", this);
+    m_actKillCgroup->setToolTip("SIGKILL em todos os processos do cgroup (serviço/escopo) do processo");
+    m_actKillCgroup->setIcon(style()->standardIcon(QStyle::SP_BrowserStop));
+    addAction(m_actKillCgroup);
+    connect(m_actKillCgroup, &QAction::triggered, this, &MainWindow::killSelectedCgroup);
 }
 
 void MainWindow::setupShortcuts() {
@@ -231,28 +447,266 @@ void MainWindow::showAndRaise() {
     activateWindow();
 }
 
+void MainWindow::setScanThreads(int threads) {
+    m_sampler->setScanThreads(threads);
+}
+
+void MainWindow::setProcEvents(bool enabled) {
+    m_sampler->setEventDriven(enabled);
+}
+
+void MainWindow::setKillGraceMs(int ms) {
+    m_killWatcher->setGraceMs(ms);
+}
+
+void MainWindow::setElevatedSessionSec(int sec) {
+    m_jobs->setElevatedSessionSec(sec);
+}
+
+void MainWindow::setRefreshIntervals(int tableMs, int headerMs) {
+    m_refreshMs = std::max(tableMs, 1);
+    m_headerMs = std::max(headerMs, 1);
+    if (m_actTurbo->isChecked()) return;
+    m_sampler->setIntervalMs(m_refreshMs);
+    m_sampler->setHeaderIntervalMs(m_headerMs);
+}
+
+void MainWindow::setRefreshBudget(double fraction) {
+    m_refreshBudget = std::max(fraction, 0.0);
+    if (!m_actTurbo->isChecked()) m_sampler->setBudget(m_refreshBudget);
+}
+
+void MainWindow::setTurbo(bool enabled) {
+    m_sampler->setIntervalMs(enabled ? kTurboMs : m_refreshMs);
+    m_sampler->setHeaderIntervalMs(enabled ? kTurboMs : m_headerMs);
+    m_sampler->setBudget(enabled ? 0.0 : m_refreshBudget);
+    // The current wait was scheduled at the old rate.
+    if (enabled) m_sampler->requestNow();
+}
+
+void MainWindow::setHistoryMiB(int mib) {
+    m_history->configure((size_t)std::max(mib, 0) << 20, kHistorySamples);
+    m_table->setColumnHidden(5, !m_history->enabled());
+}
+
+void MainWindow::setFlightRecorder(const FlightRecorder* recorder) {
+    m_flight = recorder;
+    m_actFlight->setVisible(recorder != nullptr);
+    m_actFlight->setEnabled(recorder != nullptr);
+}
+
+void MainWindow::showFlightLog() {
+    if (!m_flight) return;
+    FlightDialog dialog(m_flight, this);
+    dialog.exec();
+}
+
+void MainWindow::setRecordPath(const QString& path) {
+    m_sampler->setRecordPath(QFile::encodeName(path).toStdString());
+}
+
+bool MainWindow::openReplay(const QString& path) {
+    auto reader = std::make_unique<SnapshotReader>();
+    std::string error;
+    if (!reader->open(QFile::encodeName(path).constData(), &error)) {
+        QMessageBox::warning(this, "Replay", QString("Não foi possível abrir %1:\n%2")
+                                                 .arg(path, QString::fromLocal8Bit(error.c_str())));
+        return false;
+    }
+
+    // The live system is not sampled while a recording is shown.
+    m_sampler->pause();
+    m_model->setSnapshot(nullptr);
+    m_treeModel->setSnapshot(nullptr);
+    setThreadsVisible(false);
+    m_sampler->slot().release(m_front);
+    m_front = nullptr;
+
+    m_replay = std::move(reader);
+    m_replayFrames = std::make_unique<Snapshot[]>(2);
+    m_history->clear();
+    // Recordings have no threads, and nothing in them can be killed.
+    for (QAction* a : {m_actRefresh, m_actTurbo, m_actThreads, m_actKill, m_actForce, m_actKillTree,
+                       m_actForceTree, m_actKillCgroup}) {
+        a->setEnabled(false);
+    }
+    setWindowTitle(QString("FrogKill — %1").arg(QFileInfo(path).fileName()));
+
+    m_replayBar->show();
+    m_replaySlider->setRange(0, (int)m_replay->frameCount() - 1);
+    m_replaySlider->setValue(0);
+    showReplayFrame(0);
+    return true;
+}
+
+void MainWindow::showReplayFrame(int frame) {
+    if (!m_replay) return;
+    // The models still point at the frame shown last, so use the other one.
+    Snapshot* next = &m_replayFrames[m_front == &m_replayFrames[0] ? 1 : 0];
+    if (!m_replay->read((size_t)frame, *next)) {
+        setReplayPlaying(false);
+        statusBar()->showMessage(QString("Quadro %1 da gravação está corrompido.").arg(frame + 1), 4000);
+        return;
+    }
+    // Recorded sequence numbers repeat when seeking back; the filter
+    // caches by seq.
+    next->seq = ++m_replaySeq;
+    // The history only makes sense for consecutive frames.
+    if (frame != m_replayFrame + 1) m_history->clear();
+    m_replayFrame = frame;
+    present(next);
+    m_replayTime->setText(QString("%1  (%2/%3)")
+                              .arg(QDateTime::fromMSecsSinceEpoch(next->timeMs).toString("dd/MM/yyyy HH:mm:ss"))
+                              .arg(frame + 1)
+                              .arg(m_replay->frameCount()));
+}
+
+// Time to wait before showing the frame after `frame`: the recorded gap,
+// sped up.
+static int replayDelayMs(const SnapshotReader& replay, int frame, int speed) {
+    const long long gap = replay.frameTimeMs((size_t)frame + 1) - replay.frameTimeMs((size_t)frame);
+    return (int)std::clamp(gap / std::max(speed, 1), 16LL, 10'000LL);
+}
+
+void MainWindow::setReplayPlaying(bool playing) {
+    if (!m_replay) return;
+    m_replayPlay->blockSignals(true);
+    m_replayPlay->setChecked(playing);
+    m_replayPlay->blockSignals(false);
+    m_replayPlay->setIcon(style()->standardIcon(playing ? QStyle::SP_MediaPause : QStyle::SP_MediaPlay));
+    if (!playing) {
+        m_replayTimer->stop();
+        return;
+    }
+    // Play from the start again once at the end.
+    if (m_replaySlider->value() == m_replaySlider->maximum()) m_replaySlider->setValue(0);
+    m_replayTimer->start(replayDelayMs(*m_replay, m_replaySlider->value(), m_replaySpeed->currentData().toInt()));
+}
+
+void MainWindow::replayStep() {
+    const int frame = m_replaySlider->value() + 1;
+    if (frame > m_replaySlider->maximum()) {
+        setReplayPlaying(false);
+        return;
+    }
+    m_replaySlider->setValue(frame);
+    if (frame == m_replaySlider->maximum()) setReplayPlaying(false);
+    else if (m_replayPlay->isChecked()) {
+        m_replayTimer->start(replayDelayMs(*m_replay, frame, m_replaySpeed->currentData().toInt()));
+    }
+}
+
 void MainWindow::showEvent(QShowEvent* e) {
     QMainWindow::showEvent(e);
-    refreshNow();
-    if (m_timer) m_timer->start();
+    // The handle exists once shown; its expose events tell when the window
+    // is fully covered.
+    if (!m_watchingExpose && windowHandle()) {
+        windowHandle()->installEventFilter(this);
+        m_watchingExpose = true;
+    }
+    updateSampling();
 }
 
 void MainWindow::hideEvent(QHideEvent* e) {
     QMainWindow::hideEvent(e);
-    if (m_timer) m_timer->stop();
+    // isVisible() may still hold during the event.
+    if (m_sampler && m_sampling) {
+        m_sampling = false;
+        m_sampler->pause();
+    }
+}
+
+void MainWindow::changeEvent(QEvent* e) {
+    QMainWindow::changeEvent(e);
+    if (e->type() == QEvent::WindowStateChange) updateSampling();
+}
+
+bool MainWindow::eventFilter(QObject* watched, QEvent* e) {
+    if (watched == windowHandle() && e->type() == QEvent::Expose) updateSampling();
+    return QMainWindow::eventFilter(watched, e);
+}
+
+void MainWindow::updateSampling() {
+    if (!m_sampler || m_replay) return;
+    const QWindow* window = windowHandle();
+    const bool active = isVisible() && !isMinimized() && window && window->isExposed();
+    if (active == m_sampling) return;
+    m_sampling = active;
+    // Resuming samples at once, so the table is current when uncovered.
+    if (active) m_sampler->resume();
+    else m_sampler->pause();
 }
 
 void MainWindow::refreshNow() {
-    m_model->refresh();
+    // Asynchronous: the sampler thread wakes up and applySnapshot() follows.
+    m_sampler->requestNow();
+}
+
+void MainWindow::applySnapshot() {
+    m_sampler->acknowledge();
+    if (Snapshot* fresh = m_sampler->slot().take()) m_sampler->slot().release(present(fresh));
+    // Header ticks between table samples.
+    SystemSnapshot header;
+    if (m_front && m_sampler->takeHeader(m_front->seq, header)) showHeader(header);
+}
+
+Snapshot* MainWindow::present(Snapshot* fresh) {
+    // The filter has to describe `fresh` before the model moves to it: the
+    // proxy tests inserted and changed rows as they are signalled.
+    const bool filtering = m_procFilter->active();
+    if (filtering) m_procFilter->apply(fresh->procs, fresh->seq);
+    m_history->update(fresh->procs);
+
+    // Only pointer swaps here; the model reads the snapshot in place. The
+    // hidden view's model is detached and costs nothing.
+    if (m_treeMode) m_treeModel->setSnapshot(fresh);
+    else m_model->setSnapshot(fresh);
+    if (m_actThreads->isChecked()) m_threadModel->setSnapshot(fresh);
+    Snapshot* old = m_front;
+    m_front = fresh;
+
+    // Rows can also cross a numeric term (cpu>50) without a visible change.
+    if (filtering) (m_treeMode ? m_treeProxy : m_proxy)->refilter();
+    // Sparklines move every tick but are not model data: repaint them.
+    if (!m_treeMode && !m_table->isColumnHidden(5)) {
+        m_table->viewport()->update(m_table->columnViewportPosition(5), 0, m_table->columnWidth(5),
+                                    m_table->viewport()->height());
+    }
+
+    showHeader(fresh->sys);
+    if (m_chipProcs) {
+        m_chipProcs->setText(QString("Proc %1")
+                             .arg(fresh->procs.size()));
+    }
 
-    const auto snap = m_sys.sample();
+    // Replay shows the frame time in its own bar.
+    if (!m_replay) {
+        QString message = QString("Atualizado: %1")
+                              .arg(QDateTime::fromMSecsSinceEpoch(fresh->timeMs).toString("HH:mm:ss"));
+        // Say so when the budget slowed the table down.
+        const int intervalMs = m_sampler->effectiveIntervalMs();
+        if (!m_actTurbo->isChecked() && intervalMs > m_refreshMs) {
+            message += QString(" — tabela a cada %1 s (%2 ms de CPU por atualização)")
+                           .arg(intervalMs / 1000.0, 0, 'f', 1)
+                           .arg(m_sampler->sampleCpuMs(), 0, 'f', 0);
+        }
+        statusBar()->showMessage(message, std::max(1500, intervalMs + 500));
+    }
+    QAbstractItemView* view = currentView();
+    if (view->model()->rowCount() > 0 && !view->currentIndex().isValid()) {
+        view->setCurrentIndex(view->model()->index(0, 0));
+    }
+    return old;
+}
+
+void MainWindow::showHeader(const SystemSnapshot& sys) {
     if (m_chipCpu) {
         m_chipCpu->setText(QString("CPU %1%")
-                           .arg(snap.cpuPercent, 0, 'f', 1));
+                           .arg(sys.cpuPercent, 0, 'f', 1));
     }
     if (m_chipMem) {
-        const double usedGiB = snap.memUsedMiB / 1024.0;
-        const double totalGiB = snap.memTotalMiB / 1024.0;
+        const double usedGiB = sys.memUsedMiB / 1024.0;
+        const double totalGiB = sys.memTotalMiB / 1024.0;
         if (totalGiB > 0.0) {
             m_chipMem->setText(QString("RAM %1/%2 GiB")
                                .arg(usedGiB, 0, 'f', 1)
@@ -261,19 +715,6 @@ void MainWindow::refreshNow() {
             m_chipMem->setText("RAM —");
         }
     }
-    if (m_chipProcs) {
-        m_chipProcs->setText(QString("Proc %1")
-                             .arg(m_model->rowCount()));
-    }
-
-    statusBar()->showMessage(
-        QString("Atualizado: %1")
-            .arg(QDateTime::currentDateTime().toString("HH:mm:ss")),
-        1500
-    );
-    if (m_table->model()->rowCount() > 0 && !m_table->currentIndex().isValid()) {
-        m_table->selectRow(0);
-    }
 }
 
 static bool askConfirm(QWidget* parent, const QString& title, const QString& msg) {
@@ -283,169 +724,185 @@ static bool askConfirm(QWidget* parent, const QString& title, const QString& msg
     return ret == QMessageBox::Yes;
 }
 
-void MainWindow::killSelectedTerm() {
-    const auto idx = m_table->currentIndex();
-    if (!idx.isValid()) return;
-
-    const int srcRow = m_proxy->mapToSource(idx).row();
-    const int pid = m_model->pidAtRow(srcRow);
-    const QString name = m_model->nameAtRow(srcRow);
-
-    if (!askConfirm(this, "Confirmar",
-                    QString("Tem certeza que deseja finalizar \"%1\" (PID %2)?")
-                        .arg(name).arg(pid))) {
-        return;
-    }
+void MainWindow::applyFilter() {
+    if (m_front) m_procFilter->apply(m_front->procs, m_front->seq);
+    // The detached model has no rows, so refiltering it is free.
+    m_proxy->refilter();
+    m_treeProxy->refilter();
+}
 
-    tryKillPid(pid, SIGTERM, /*allowElevate=*/true);
-    refreshNow();
+QAbstractItemView* MainWindow::currentView() const {
+    if (m_treeMode) return m_tree;
+    return m_table;
 }
 
-void MainWindow::killSelectedKill() {
-    const auto idx = m_table->currentIndex();
-    if (!idx.isValid()) return;
+KillTarget MainWindow::targetAt(const QModelIndex& index) const {
+    return {index.data(PidRole).toInt(), index.data(StartTimeRole).toULongLong(), index.data(NameRole).toString()};
+}
 
-    const int srcRow = m_proxy->mapToSource(idx).row();
-    const int pid = m_model->pidAtRow(srcRow);
-    const QString name = m_model->nameAtRow(srcRow);
+void MainWindow::setTreeMode(bool enabled) {
+    if (enabled == m_treeMode) return;
+    // Keep the current process selected across the switch.
+    const QModelIndex current = currentView()->currentIndex();
+    const int pid = current.isValid() ? targetAt(current).pid : 0;
+
+    m_treeMode = enabled;
+    m_actTreeView->setChecked(enabled);
+    if (enabled) {
+        m_model->setSnapshot(nullptr);
+        m_treeModel->setSnapshot(m_front);
+        m_tree->expandToDepth(0);
+        m_views->setCurrentWidget(m_tree);
+    } else {
+        m_treeModel->setSnapshot(nullptr);
+        m_model->setSnapshot(m_front);
+        m_views->setCurrentWidget(m_table);
+    }
 
-    if (!askConfirm(this, "Confirmar",
-                    QString("Tem certeza que deseja FORÇAR (SIGKILL) \"%1\" (PID %2)?")
-                        .arg(name).arg(pid))) {
-        return;
+    QAbstractItemView* view = currentView();
+    if (pid > 0) {
+        const QModelIndexList hit = view->model()->match(view->model()->index(0, 0), PidRole, pid, 1,
+                                                         Qt::MatchExactly | Qt::MatchRecursive);
+        if (!hit.isEmpty()) {
+            view->setCurrentIndex(hit.front());
+            view->scrollTo(hit.front());
+        }
     }
+    view->setFocus();
+    updateTaskPids();
+}
 
-    tryKillPid(pid, SIGKILL, /*allowElevate=*/true);
-    refreshNow();
+void MainWindow::setThreadsVisible(bool visible) {
+    m_actThreads->setChecked(visible);
+    m_threadView->setVisible(visible);
+    m_threadModel->setSnapshot(visible ? m_front : nullptr);
+    updateTaskPids();
+    if (visible) refreshNow();
 }
 
-int MainWindow::estimateTreeSize(int rootPid) const {
-    if (!m_model || rootPid <= 0) return 1;
-    const int n = m_model->rowCount();
-    std::unordered_map<int, std::vector<int>> children;
-    children.reserve((size_t)n * 2u + 8u);
-    for (int r = 0; r < n; ++r) {
-        const int pid = m_model->pidAtRow(r);
-        const int ppid = m_model->ppidAtRow(r);
-        if (pid > 1 && ppid >= 0) {
-            children[ppid].push_back(pid);
-        }
-    }
-    std::vector<int> stack;
-    stack.reserve(256);
-    stack.push_back(rootPid);
-    int count = 0;
-    while (!stack.empty()) {
-        const int pid = stack.back();
-        stack.pop_back();
-        ++count;
-        auto it = children.find(pid);
-        if (it == children.end()) continue;
-        for (int c : it->second) stack.push_back(c);
-    }
-    return count;
-}
-
-static std::vector<int> buildTreePostorder(const ProcessModel* model, int rootPid) {
-    std::vector<int> empty;
-    if (!model || rootPid <= 0) return empty;
-    const int n = model->rowCount();
-    std::unordered_map<int, std::vector<int>> children;
-    children.reserve((size_t)n * 2u + 8u);
-    for (int r = 0; r < n; ++r) {
-        const int pid = model->pidAtRow(r);
-        const int ppid = model->ppidAtRow(r);
-        if (pid > 1 && ppid >= 0) {
-            children[ppid].push_back(pid);
-        }
+void MainWindow::updateTaskPids() {
+    // A few processes at most: each costs one stat read per thread per tick.
+    constexpr size_t kMaxTaskPids = 16;
+    std::vector<int> pids;
+    if (m_actThreads->isChecked()) {
+        for (const KillTarget& t : selectedTargets()) pids.push_back(t.pid);
+        std::sort(pids.begin(), pids.end());
+        pids.erase(std::unique(pids.begin(), pids.end()), pids.end());
+        if (pids.size() > kMaxTaskPids) pids.resize(kMaxTaskPids);
     }
+    if (!m_sampler || pids == m_taskPids) return;
+    m_taskPids = pids;
+    m_sampler->setTaskPids(std::move(pids));
+}
 
-    // Two-stack postorder: stack2 reversed yields children-first order.
-    std::vector<int> stack1;
-    std::vector<int> stack2;
-    stack1.reserve(256);
-    stack2.reserve(256);
-    stack1.push_back(rootPid);
-    while (!stack1.empty()) {
-        const int pid = stack1.back();
-        stack1.pop_back();
-        stack2.push_back(pid);
-        auto it = children.find(pid);
-        if (it == children.end()) continue;
-        for (int c : it->second) {
-            stack1.push_back(c);
-        }
+std::vector<KillTarget> MainWindow::selectedTargets() const {
+    QAbstractItemView* view = currentView();
+    std::vector<KillTarget> out;
+    QModelIndexList rows = view->selectionModel()->selectedRows();
+    if (rows.isEmpty() && view->currentIndex().isValid()) rows.push_back(view->currentIndex());
+    // Stable order for the confirmation list: table order, or PIDs in the
+    // tree (where rows are only ordered among siblings).
+    if (!m_treeMode) {
+        std::sort(rows.begin(), rows.end(), [](const QModelIndex& a, const QModelIndex& b) { return a.row() < b.row(); });
+    }
+    out.reserve((size_t)rows.size());
+    for (const auto& idx : rows) out.push_back(targetAt(idx));
+    if (m_treeMode) {
+        std::sort(out.begin(), out.end(), [](const KillTarget& a, const KillTarget& b) { return a.pid < b.pid; });
     }
-    std::reverse(stack2.begin(), stack2.end());
-    return stack2;
+    return out;
 }
 
-void MainWindow::killSelectedTreeTerm() {
-    const auto idx = m_table->currentIndex();
-    if (!idx.isValid()) return;
+void MainWindow::selectAllFiltered() {
+    // Only rows matching the filter are in the proxy (in the tree, selectAll
+    // covers the expanded ones).
+    QAbstractItemView* view = currentView();
+    view->selectAll();
+    statusBar()->showMessage(
+        QString("%1 processos selecionados.").arg(view->selectionModel()->selectedRows().size()), 3000);
+}
 
-    const int srcRow = m_proxy->mapToSource(idx).row();
-    const int rootPid = m_model->pidAtRow(srcRow);
-    const QString name = m_model->nameAtRow(srcRow);
+void MainWindow::killSelectedTerm() {
+    killSelected(SIGTERM);
+}
 
-    const int treeSize = estimateTreeSize(rootPid);
-    const QString msg = (treeSize <= 1)
-        ? QString("Tem certeza que deseja finalizar \"%1\" (PID %2)?").arg(name).arg(rootPid)
-        : QString("Tem certeza que deseja finalizar a ÁRVORE de \"%1\" (PID %2)?\n\nIsso pode encerrar %3 processos.")
-            .arg(name).arg(rootPid).arg(treeSize);
+void MainWindow::killSelectedKill() {
+    killSelected(SIGKILL);
+}
 
+void MainWindow::killSelected(int sig) {
+    auto targets = selectedTargets();
+    if (targets.empty()) return;
+
+    QString msg;
+    QString title;
+    if (targets.size() == 1) {
+        const KillTarget& t = targets.front();
+        msg = (sig == SIGKILL)
+            ? QString("Tem certeza que deseja FORÇAR (SIGKILL) \"%1\" (PID %2)?")
+            : QString("Tem certeza que deseja finalizar \"%1\" (PID %2)?");
+        msg = msg.arg(t.name).arg(t.pid);
+        title = QString("SIG%1 \"%2\" (PID %3)").arg(sigName(sig), t.name).arg(t.pid);
+    } else {
+        // One confirmation for the whole batch, listing the first few targets.
+        constexpr size_t kListed = 12;
+        QString list;
+        for (size_t i = 0; i < targets.size() && i < kListed; ++i) {
+            list += QString("\n  • %1 (PID %2)").arg(targets[i].name).arg(targets[i].pid);
+        }
+        if (targets.size() > kListed) list += QString("\n  … e mais %1").arg(targets.size() - kListed);
+        msg = (sig == SIGKILL)
+            ? QString("Tem certeza que deseja FORÇAR (SIGKILL) %1 processos?\n%2")
+            : QString("Tem certeza que deseja finalizar %1 processos?\n%2");
+        msg = msg.arg(targets.size()).arg(list);
+        title = QString("SIG%1 em %2 processos").arg(sigName(sig)).arg(targets.size());
+    }
     if (!askConfirm(this, "Confirmar", msg)) return;
 
-    if (rootPid <= 1) {
+    if (targets.size() == 1 && targets.front().pid <= 1) {
         QMessageBox::warning(this, "Bloqueado", "Por segurança, o FrogKill não finaliza PID <= 1.");
         return;
     }
+    m_jobs->start(KillJobs::Kind::Processes, sig, std::move(targets), title);
+}
 
-    const auto order = buildTreePostorder(m_model, rootPid);
-    const qint64 selfPid = QCoreApplication::applicationPid();
-
-    for (int pid : order) {
-        if (pid <= 1) continue;
-        if (pid == (int)selfPid) continue;
-        if (::kill(pid, SIGTERM) == 0) continue;
-        const int e = errno;
-        if (e == ESRCH) continue; // already gone
-        if (e == EPERM) {
-            // Ask once and use helper for the whole tree.
-            const auto ret = QMessageBox::question(
-                this,
-                "Permissão necessária",
-                QString("Sem permissão para finalizar toda a árvore do PID %1.\n\nExecutar como administrador (pedir senha)?").arg(rootPid),
-                QMessageBox::Yes | QMessageBox::No,
-                QMessageBox::No
-            );
-            if (ret == QMessageBox::Yes) {
-                elevateKillPid(rootPid, SIGTERM, /*tree=*/true);
-            }
-            break;
-        }
-        QMessageBox::warning(this, "Erro",
-                             QString("Falha ao finalizar PID %1 (SIGTERM): %2")
-                                 .arg(pid)
-                                 .arg(QString::fromLocal8Bit(std::strerror(e))));
-        break;
-    }
-    refreshNow();
+int MainWindow::estimateTreeSize(int rootPid) const {
+    if (!m_front || rootPid <= 0) return 1;
+    const ProcIndex& tree = m_front->tree;
+    const uint32_t row = tree.rowOf(rootPid);
+    return row == ProcIndex::kNone ? 1 : (int)tree.subtreeSize(row);
+}
+
+void MainWindow::killSelectedTreeTerm() {
+    killSelectedTree(SIGTERM);
 }
 
 void MainWindow::killSelectedTreeKill() {
-    const auto idx = m_table->currentIndex();
+    killSelectedTree(SIGKILL);
+}
+
+void MainWindow::killSelectedTree(int sig) {
+    const auto idx = currentView()->currentIndex();
     if (!idx.isValid()) return;
 
-    const int srcRow = m_proxy->mapToSource(idx).row();
-    const int rootPid = m_model->pidAtRow(srcRow);
-    const QString name = m_model->nameAtRow(srcRow);
+    const KillTarget target = targetAt(idx);
+    const int rootPid = target.pid;
+    const unsigned long long startTime = target.startTime;
+    const QString name = target.name;
 
     const int treeSize = estimateTreeSize(rootPid);
-    const QString msg = (treeSize <= 1)
-        ? QString("Tem certeza que deseja FORÇAR (SIGKILL) \"%1\" (PID %2)?").arg(name).arg(rootPid)
-        : QString("Tem certeza que deseja FORÇAR (SIGKILL) a ÁRVORE de \"%1\" (PID %2)?\n\nIsso pode encerrar %3 processos.")
-            .arg(name).arg(rootPid).arg(treeSize);
+    QString msg;
+    if (sig == SIGKILL) {
+        msg = (treeSize <= 1)
+            ? QString("Tem certeza que deseja FORÇAR (SIGKILL) \"%1\" (PID %2)?").arg(name).arg(rootPid)
+            : QString("Tem certeza que deseja FORÇAR (SIGKILL) a ÁRVORE de \"%1\" (PID %2)?\n\nIsso pode encerrar %3 processos.")
+                .arg(name).arg(rootPid).arg(treeSize);
+    } else {
+        msg = (treeSize <= 1)
+            ? QString("Tem certeza que deseja finalizar \"%1\" (PID %2)?").arg(name).arg(rootPid)
+            : QString("Tem certeza que deseja finalizar a ÁRVORE de \"%1\" (PID %2)?\n\nIsso pode encerrar %3 processos.")
+                .arg(name).arg(rootPid).arg(treeSize);
+    }
 
     if (!askConfirm(this, "Confirmar", msg)) return;
 
@@ -454,102 +911,54 @@ void MainWindow::killSelectedTreeKill() {
         return;
     }
 
-    const auto order = buildTreePostorder(m_model, rootPid);
-    const qint64 selfPid = QCoreApplication::applicationPid();
-
-    for (int pid : order) {
-        if (pid <= 1) continue;
-        if (pid == (int)selfPid) continue;
-        if (::kill(pid, SIGKILL) == 0) continue;
-        const int e = errno;
-        if (e == ESRCH) continue;
-        if (e == EPERM) {
-            const auto ret = QMessageBox::question(
-                this,
-                "Permissão necessária",
-                QString("Sem permissão para forçar toda a árvore do PID %1.\n\nExecutar como administrador (pedir senha)?").arg(rootPid),
-                QMessageBox::Yes | QMessageBox::No,
-                QMessageBox::No
-            );
-            if (ret == QMessageBox::Yes) {
-                elevateKillPid(rootPid, SIGKILL, /*tree=*/true);
-            }
-            break;
-        }
-        QMessageBox::warning(this, "Erro",
-                             QString("Falha ao forçar PID %1 (SIGKILL): %2")
-                                 .arg(pid)
-                                 .arg(QString::fromLocal8Bit(std::strerror(e))));
-        break;
-    }
-    refreshNow();
+    m_jobs->start(KillJobs::Kind::Tree, sig, {{rootPid, startTime, name}},
+                  QString("SIG%1 na árvore de \"%2\" (PID %3)").arg(sigName(sig), name).arg(rootPid));
 }
 
-bool MainWindow::tryKillPid(int pid, int sig, bool allowElevate) {
+void MainWindow::killSelectedCgroup() {
+    const auto idx = currentView()->currentIndex();
+    if (!idx.isValid()) return;
+
+    const KillTarget target = targetAt(idx);
+    const int pid = target.pid;
+    const unsigned long long startTime = target.startTime;
+    const QString name = target.name;
+
     if (pid <= 1) {
         QMessageBox::warning(this, "Bloqueado", "Por segurança, o FrogKill não finaliza PID <= 1.");
-        return false;
+        return;
     }
 
-    if (::kill(pid, sig) == 0) {
-        return true;
+    // Covers what the PPID tree misses (double forks, daemons reparented
+    // to init): every process of the unit/scope goes in one operation.
+    std::string path;
+    if (!cgroupOf(pid, path)) {
+        QMessageBox::warning(this, "Indisponível",
+                             QString("Não foi possível obter o cgroup v2 do PID %1.").arg(pid));
+        return;
     }
-
-    const int e = errno;
-    if (e == EPERM && allowElevate) {
-        const auto ret = QMessageBox::question(
-            this,
-            "Permissão necessária",
-            QString("Sem permissão para enviar SIG%1 ao PID %2.\n\nExecutar como administrador (pedir senha)?")
-                .arg(sigName(sig)).arg(pid),
-            QMessageBox::Yes | QMessageBox::No,
-            QMessageBox::No
-        );
-        if (ret == QMessageBox::Yes) {
-            return elevateKillPid(pid, sig, /*tree=*/false);
-        }
-        return false;
+    const QString cg = QString::fromStdString(path);
+    std::vector<int> members;
+    const int check = checkCgroupTarget(path, &members);
+    if (check == EDEADLK) {
+        QMessageBox::warning(this, "Bloqueado",
+                             QString("O próprio FrogKill está no cgroup %1.\n\nUse a opção de árvore.").arg(cg));
+        return;
     }
-
-    QMessageBox::warning(this, "Erro",
-                         QString("Falha ao finalizar PID %1 (SIG%2): %3")
-                             .arg(pid).arg(sigName(sig)).arg(QString::fromLocal8Bit(std::strerror(e))));
-    return false;
-}
-
-bool MainWindow::elevateKillPid(int pid, int sig, bool tree) {
-    // Call pkexec helper. Polkit will prompt the user for a password via the desktop auth agent.
-    QString helper = QStringLiteral(FROGKILL_HELPER_PATH);
-
-    QStringList args;
-    args << "--disable-internal-agent"
-         << helper
-         << "--pid" << QString::number(pid)
-         << "--sig" << sigName(sig);
-    if (tree) {
-        args << "--tree";
+    if (check != 0) {
+        QMessageBox::warning(this, "Bloqueado",
+                             QString("Por segurança, o FrogKill não finaliza o cgroup %1.").arg(cg));
+        return;
     }
 
-    QProcess p;
-    p.setProgram("pkexec");
-    p.setArguments(args);
-    p.setProcessChannelMode(QProcess::MergedChannels);
-
-    p.start();
-    if (!p.waitForFinished(-1)) {
-        QMessageBox::warning(this, "Erro", "Falha ao executar pkexec.");
-        return false;
+    if (!askConfirm(this, "Confirmar",
+                    QString("Tem certeza que deseja FORÇAR (SIGKILL) todo o cgroup de \"%1\" (PID %2)?\n\n%3\n\nIsso pode encerrar %4 processos.")
+                        .arg(name).arg(pid).arg(cg).arg(members.size()))) {
+        return;
     }
 
-    const int code = p.exitCode();
-    const QString out = QString::fromLocal8Bit(p.readAll());
-
-    if (code == 0) return true;
-
-    QMessageBox::warning(this, "Erro",
-                         QString("Helper retornou código %1.\n\nSaída:\n%2")
-                             .arg(code).arg(out.trimmed()));
-    return false;
+    m_jobs->start(KillJobs::Kind::Cgroup, SIGKILL, {{pid, startTime, name}},
+                  QString("SIGKILL no cgroup %1").arg(cg));
 }
 
 } // namespace FrogKill
@@ -1,23 +1,46 @@
 #pragma once
 #include <QMainWindow>
-#include <QSortFilterProxyModel>
 
-#include "system_sampler.h"
+#include <memory>
+#include <vector>
+
+#include "kill_jobs.h"
 
 // Forward declarations MUST be in the global namespace. If you write
 // `class QLineEdit*` inside namespace FrogKill, you accidentally declare
 // FrogKill::QLineEdit instead of ::QLineEdit.
+class QAbstractItemView;
+class QComboBox;
 class QLineEdit;
+class QModelIndex;
+class QPoint;
+class QSlider;
+class QSplitter;
+class QStackedWidget;
 class QTableView;
-class QLabel;
 class QTimer;
+class QToolButton;
+class QTreeView;
+class QLabel;
 class QAction;
 class QToolBar;
 class QFrame;
 
 namespace FrogKill {
 
+class FlightRecorder;
+class JobPanel;
+class KillWatcher;
+class ProcFilter;
+class ProcHistory;
+class ProcessFilterProxy;
 class ProcessModel;
+class ProcessTreeModel;
+class SamplerThread;
+class SnapshotReader;
+class ThreadModel;
+struct Snapshot;
+struct SystemSnapshot;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -26,22 +49,76 @@ public:
     ~MainWindow() override;
 
     void showAndRaise();
+    void setScanThreads(int threads);
+    void setProcEvents(bool enabled);
+    // SIGTERM -> SIGKILL escalation delay (0 = never escalate).
+    void setKillGraceMs(int ms);
+    // Keep one elevated helper session alive for this long when idle
+    // (0 = one pkexec per elevated action).
+    void setElevatedSessionSec(int sec);
+    // Process table and header refresh intervals.
+    void setRefreshIntervals(int tableMs, int headerMs);
+    // CPU the table refresh may use (fraction of one core) before its
+    // interval is stretched; 0 = fixed interval.
+    void setRefreshBudget(double fraction);
+    // Memory for the history column (0 hides it).
+    void setHistoryMiB(int mib);
+    // Records every snapshot to `path` while the window samples.
+    void setRecordPath(const QString& path);
+    // Shows a recording instead of the live system; kills and refresh are
+    // disabled. False (after telling the user) if it cannot be read.
+    bool openReplay(const QString& path);
+    // Enables "Últimos minutos…" over the daemon's flight recorder.
+    void setFlightRecorder(const FlightRecorder* recorder);
 
 private slots:
     void refreshNow();
+    void applySnapshot();
+    // Replay: shows frame `frame` of the recording.
+    void showReplayFrame(int frame);
+    void setReplayPlaying(bool playing);
+    void replayStep();
+    void showFlightLog();
+    // Fast refresh while investigating: both rates at kTurboMs, no budget.
+    void setTurbo(bool enabled);
     void killSelectedTerm();
     void killSelectedKill();
     void killSelectedTreeTerm();
     void killSelectedTreeKill();
+    void killSelectedCgroup();
+    void selectAllFiltered();
+    // Switches between the flat table and the process hierarchy.
+    void setTreeMode(bool enabled);
+    // Shows the threads of the selected processes under the list.
+    void setThreadsVisible(bool visible);
+    // Tells the sampler which processes' threads to read (none while the
+    // thread panel is closed).
+    void updateTaskPids();
 
 private:
     void setupActions();
-    bool tryKillPid(int pid, int sig, bool allowElevate);
-    bool elevateKillPid(int pid, int sig, bool tree);
-
-    // For tree operations we compute the list in the GUI for confirmation only.
-    // The actual termination may be done either directly (user has permission)
-    // or via the polkit helper (pkexec) using --tree.
+    // Points the models and header at `fresh`; returns the previous front.
+    Snapshot* present(Snapshot* fresh);
+    // Sets the CPU/RAM chips.
+    void showHeader(const SystemSnapshot& sys);
+    // Samples only while the window can be seen: shown, not minimized and
+    // not fully covered.
+    void updateSampling();
+    // Re-evaluates the filter query on the current snapshot.
+    void applyFilter();
+    QAbstractItemView* currentView() const;
+    KillTarget targetAt(const QModelIndex& index) const;
+    void showContextMenu(QAbstractItemView* view, const QPoint& pos);
+    // Selected rows in view order (the current row if nothing is selected).
+    std::vector<KillTarget> selectedTargets() const;
+    // Confirms and queues a kill job for the selection (one confirmation
+    // and one elevated round-trip for a batch).
+    void killSelected(int sig);
+    void killSelectedTree(int sig);
+
+    // For tree operations the size is only shown for confirmation (an
+    // O(1) lookup in the snapshot's parent index). The actual termination
+    // walks the live tree, directly or via the polkit helper using --tree.
     int estimateTreeSize(int rootPid) const;
     void setupUi();
     void setupShortcuts(); // keeps local Ctrl+Shift+Esc while window is focused
@@ -50,29 +127,78 @@ private:
 protected:
     void showEvent(QShowEvent* e) override;
     void hideEvent(QHideEvent* e) override;
+    void changeEvent(QEvent* e) override;
+    // Expose events of the window handle (occlusion).
+    bool eventFilter(QObject* watched, QEvent* e) override;
 
+    // Only the model of the visible view follows the snapshots; the other
+    // one is detached.
     ProcessModel* m_model{nullptr};
-    QSortFilterProxyModel* m_proxy{nullptr};
+    ProcessFilterProxy* m_proxy{nullptr};
+    ProcessTreeModel* m_treeModel{nullptr};
+    ProcessFilterProxy* m_treeProxy{nullptr};
+    bool m_treeMode{false};
+    // Query of the filter box, shared by both proxies.
+    std::unique_ptr<ProcFilter> m_procFilter;
+    // Recent CPU/RAM per process, fed with every snapshot shown.
+    std::unique_ptr<ProcHistory> m_history;
 
     QLineEdit* m_filter{nullptr};
+    QStackedWidget* m_views{nullptr};
     QTableView* m_table{nullptr};
+    QTreeView* m_tree{nullptr};
+    QSplitter* m_splitter{nullptr};
+    ThreadModel* m_threadModel{nullptr};
+    QTableView* m_threadView{nullptr};
+    std::vector<int> m_taskPids;
     QLabel* m_chipCpu{nullptr};
     QLabel* m_chipMem{nullptr};
     QLabel* m_chipProcs{nullptr};
-    QTimer* m_timer{nullptr};
 
     QToolBar* m_toolbar{nullptr};
     QFrame* m_header{nullptr};
 
-    SystemSampler m_sys{};
+    // Sampling runs on its own thread (only while the window is visible);
+    // m_front is the snapshot the model currently points at.
+    std::unique_ptr<SamplerThread> m_sampler;
+    Snapshot* m_front{nullptr};
+    bool m_sampling{false};
+    bool m_watchingExpose{false};
+    int m_refreshMs{1000};
+    int m_headerMs{500};
+    double m_refreshBudget{0.10};
+
+    // Replay: frames are decoded into two snapshots used alternately (the
+    // models diff against the one shown before).
+    std::unique_ptr<SnapshotReader> m_replay;
+    std::unique_ptr<Snapshot[]> m_replayFrames;
+    unsigned long long m_replaySeq{0};
+    int m_replayFrame{-1};
+    QFrame* m_replayBar{nullptr};
+    QToolButton* m_replayPlay{nullptr};
+    QSlider* m_replaySlider{nullptr};
+    QLabel* m_replayTime{nullptr};
+    QComboBox* m_replaySpeed{nullptr};
+    QTimer* m_replayTimer{nullptr};
+    const FlightRecorder* m_flight{nullptr};
+    KillWatcher* m_killWatcher{nullptr};
+    // Kills run as background jobs; the panel shows their progress.
+    KillJobs* m_jobs{nullptr};
+    JobPanel* m_jobPanel{nullptr};
 
     QAction* m_actRefresh{nullptr};
+    QAction* m_actTurbo{nullptr};
+    QAction* m_actSelectAll{nullptr};
+    QAction* m_actTreeView{nullptr};
+    QAction* m_actThreads{nullptr};
+    QAction* m_actFlight{nullptr};
 
     QAction* m_actKill{nullptr};
     QAction* m_actForce{nullptr};
 
     QAction* m_actKillTree{nullptr};
     QAction* m_actForceTree{nullptr};
+    QAction* m_actKillCgroup{nullptr};
 };
 
 } // namespace FrogKill
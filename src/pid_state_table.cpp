@@ -0,0 +1,96 @@
+#include "pid_state_table.h"
+
+#include <utility>
+
+namespace FrogKill {
+
+static constexpr size_t kInitialSlots = 1024;
+
+PidStateTable::PidStateTable() : m_slots(kInitialSlots) {}
+
+size_t PidStateTable::home(int pid, unsigned long long startTime) const {
+    uint64_t h = (uint64_t)(uint32_t)pid * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)startTime * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    return (size_t)h & (m_slots.size() - 1);
+}
+
+uint32_t PidStateTable::findSlot(int pid, unsigned long long startTime) const {
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = home(pid, startTime);; i = (i + 1) & mask) {
+        const PidState& s = m_slots[i];
+        if (s.pid == 0) return kNoSlot;
+        if (s.pid == pid && s.startTime == startTime) return (uint32_t)i;
+    }
+}
+
+PidState& PidStateTable::insert(int pid, unsigned long long startTime) {
+    // Keep the load factor <= 1/2 so probe sequences stay short.
+    if ((m_count + 1) * 2 > m_slots.size()) grow();
+    const size_t mask = m_slots.size() - 1;
+    size_t i = home(pid, startTime);
+    while (m_slots[i].pid != 0) i = (i + 1) & mask;
+
+    // Reuse whatever capacity the slot's strings still have.
+    PidState& s = m_slots[i];
+    s.pid = pid;
+    s.startTime = startTime;
+    s.procJiffies = 0;
+    s.lastSeen = 0;
+    s.uid = 0;
+    s.user = QByteArray();
+    s.cmdline.clear();
+    s.commLen = 0;
+    s.kernelThread = false;
+    s.nextRefresh = 0;
+    s.refreshStep = 1;
+    ++m_count;
+    return s;
+}
+
+void PidStateTable::grow() {
+    std::vector<PidState> old(m_slots.size() * 2);
+    old.swap(m_slots);
+    const size_t mask = m_slots.size() - 1;
+    for (auto& s : old) {
+        if (s.pid == 0) continue;
+        size_t i = home(s.pid, s.startTime);
+        while (m_slots[i].pid != 0) i = (i + 1) & mask;
+        m_slots[i] = std::move(s);
+    }
+    m_sweepPos = 0;
+}
+
+void PidStateTable::eraseAt(size_t hole) {
+    // Backward-shift deletion: pull later members of the probe run into the
+    // hole so lookups never need tombstones.
+    const size_t mask = m_slots.size() - 1;
+    for (size_t j = (hole + 1) & mask; m_slots[j].pid != 0; j = (j + 1) & mask) {
+        const size_t k = home(m_slots[j].pid, m_slots[j].startTime);
+        const bool stays = (hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j);
+        if (stays) continue;
+        std::swap(m_slots[hole], m_slots[j]);
+        hole = j;
+    }
+    m_slots[hole].pid = 0;
+    m_slots[hole].user = QByteArray();
+    --m_count;
+}
+
+size_t PidStateTable::sweep(unsigned tick, size_t budget) {
+    const size_t mask = m_slots.size() - 1;
+    size_t evicted = 0;
+    for (; budget > 0 && m_count > 0; --budget) {
+        PidState& s = m_slots[m_sweepPos];
+        if (s.pid != 0 && s.lastSeen != tick) {
+            // Something may shift into this slot; look at it again next.
+            eraseAt(m_sweepPos);
+            ++evicted;
+            continue;
+        }
+        m_sweepPos = (m_sweepPos + 1) & mask;
+    }
+    return evicted;
+}
+
+} // namespace FrogKill
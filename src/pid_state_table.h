@@ -0,0 +1,68 @@
+#pragma once
+#include <QByteArray>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace FrogKill {
+
+// What the sampler remembers about one process generation, i.e. one
+// (pid, starttime) pair. A reused PID gets a fresh entry, so CPU deltas are
+// never computed against a dead process's counters.
+struct PidState {
+    int pid{0};                           // 0 = empty slot
+    unsigned long long startTime{0};
+    long long procJiffies{0};             // utime + stime at lastSeen
+    unsigned lastSeen{0};                 // sampler tick
+
+    // Slow-changing metadata; re-read only when due (see nextRefresh) or
+    // when comm changes (exec).
+    uid_t uid{0};
+    QByteArray user;                      // UTF-8 user name for uid
+    std::string cmdline;                  // collapsed; empty = use comm
+    char comm[16]{};
+    unsigned char commLen{0};
+    bool kernelThread{false};
+    unsigned nextRefresh{0};              // tick at which metadata is re-read
+    unsigned refreshStep{1};              // backoff: 1, 2, 4 ... kMaxRefreshStep
+};
+
+// Flat, open-addressed (linear probing) table of PidState keyed on
+// (pid, starttime). Entries not seen in the current tick are evicted
+// incrementally by sweep(), a bounded slice at a time, instead of
+// rebuilding the table.
+//
+// Pointers and slot indices stay valid until the next insert() or sweep().
+class PidStateTable {
+public:
+    static constexpr uint32_t kNoSlot = ~0u;
+
+    PidStateTable();
+
+    size_t size() const { return m_count; }
+    size_t capacity() const { return m_slots.size(); }
+
+    uint32_t findSlot(int pid, unsigned long long startTime) const;
+    PidState& at(uint32_t slot) { return m_slots[slot]; }
+    const PidState& at(uint32_t slot) const { return m_slots[slot]; }
+
+    // Inserts a new generation (must not be present) and returns it.
+    PidState& insert(int pid, unsigned long long startTime);
+
+    // Examines up to `budget` slots and evicts entries whose lastSeen is not
+    // `tick`. Returns the number of evicted entries.
+    size_t sweep(unsigned tick, size_t budget);
+
+private:
+    size_t home(int pid, unsigned long long startTime) const;
+    void grow();
+    void eraseAt(size_t slot);
+
+    std::vector<PidState> m_slots;   // size is a power of two
+    size_t m_count{0};
+    size_t m_sweepPos{0};
+};
+
+} // namespace FrogKill
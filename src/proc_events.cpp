@@ -0,0 +1,151 @@
+#include "proc_events.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+// Large enough to absorb fork bursts between two ticks; ENOBUFS beyond that
+// only costs a resync.
+static constexpr int kRecvBufBytes = 4 * 1024 * 1024;
+static constexpr int kAckTimeoutMs = 250;
+static constexpr __u32 kListenAck = 0x46524f47;  // echoed back as ack + 1
+
+// The payload follows a 20-byte cn_msg, so it is not 8-byte aligned in the
+// receive buffer; copy it out instead of casting.
+static bool readEvent(const nlmsghdr* nlh, proc_event& ev, __u32& ack) {
+    if (nlh->nlmsg_type == NLMSG_ERROR || nlh->nlmsg_type == NLMSG_NOOP) return false;
+    if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(cn_msg))) return false;
+    const auto* cn = static_cast<const cn_msg*>(NLMSG_DATA(nlh));
+    const size_t avail = nlh->nlmsg_len - NLMSG_LENGTH(sizeof(cn_msg));
+    std::memset(&ev, 0, sizeof(ev));
+    std::memcpy(&ev, cn->data, std::min<size_t>({cn->len, avail, sizeof(ev)}));
+    ack = cn->ack;
+    return true;
+}
+
+ProcEvents::~ProcEvents() {
+    close();
+}
+
+bool ProcEvents::open() {
+    close();
+    m_fd = ::socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (m_fd < 0) return false;
+
+    // SO_RCVBUFFORCE ignores rmem_max but needs CAP_NET_ADMIN, which we
+    // need anyway; fall back to the capped variant.
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUFFORCE, &kRecvBufBytes, sizeof(kRecvBufBytes)) != 0) {
+        ::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &kRecvBufBytes, sizeof(kRecvBufBytes));
+    }
+
+    sockaddr_nl sa{};
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = CN_IDX_PROC;
+    sa.nl_pid = 0;  // let the kernel pick a port id
+    if (::bind(m_fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0 || !sendListen(true)) {
+        close();
+        return false;
+    }
+
+    // The kernel answers the subscription with a PROC_EVENT_NONE ack whose
+    // err is EPERM without CAP_NET_ADMIN. No answer at all (e.g. inside a
+    // PID namespace) is treated as failure too.
+    pollfd pfd{m_fd, POLLIN, 0};
+    while (::poll(&pfd, 1, kAckTimeoutMs) > 0) {
+        ssize_t n = ::recv(m_fd, m_buf, sizeof(m_buf), 0);
+        if (n <= 0) {
+            if (n < 0 && (errno == EINTR || errno == ENOBUFS)) continue;
+            break;
+        }
+        for (auto* nlh = reinterpret_cast<nlmsghdr*>(m_buf); NLMSG_OK(nlh, (unsigned)n);
+             nlh = NLMSG_NEXT(nlh, n)) {
+            proc_event ev;
+            __u32 ack = 0;
+            if (!readEvent(nlh, ev, ack)) continue;
+            if (ev.what != proc_event::PROC_EVENT_NONE || ack != kListenAck + 1) continue;
+            if (ev.event_data.ack.err == 0) return true;
+            close();
+            return false;
+        }
+    }
+    close();
+    return false;
+}
+
+void ProcEvents::close() {
+    if (m_fd < 0) return;
+    sendListen(false);
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool ProcEvents::sendListen(bool listen) {
+    alignas(NLMSG_ALIGNTO) char buf[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))]{};
+    auto* nlh = reinterpret_cast<nlmsghdr*>(buf);
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = 0;
+
+    auto* cn = static_cast<cn_msg*>(NLMSG_DATA(nlh));
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->ack = kListenAck;
+    cn->len = sizeof(proc_cn_mcast_op);
+    const proc_cn_mcast_op op = listen ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    std::memcpy(cn->data, &op, sizeof(op));
+
+    return ::send(m_fd, buf, nlh->nlmsg_len, 0) == (ssize_t)nlh->nlmsg_len;
+}
+
+void ProcEvents::drain(Batch& out) {
+    if (m_fd < 0) return;
+    for (;;) {
+        const ssize_t n = ::recv(m_fd, m_buf, sizeof(m_buf), MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            // The socket buffer overflowed: some events are gone for good.
+            if (errno == ENOBUFS) { out.overflow = true; continue; }
+            return;  // EAGAIN: drained
+        }
+        if (n == 0) return;
+
+        ssize_t left = n;
+        for (auto* nlh = reinterpret_cast<nlmsghdr*>(m_buf); NLMSG_OK(nlh, (unsigned)left);
+             nlh = NLMSG_NEXT(nlh, left)) {
+            proc_event ev;
+            __u32 ack = 0;
+            if (!readEvent(nlh, ev, ack)) continue;
+            switch (ev.what) {
+            case proc_event::PROC_EVENT_FORK:
+                if (ev.event_data.fork.child_pid == ev.event_data.fork.child_tgid) {
+                    out.added.push_back(ev.event_data.fork.child_tgid);
+                }
+                break;
+            case proc_event::PROC_EVENT_EXEC:
+                out.changed.push_back(ev.event_data.exec.process_tgid);
+                break;
+            case proc_event::PROC_EVENT_UID:
+                out.changed.push_back(ev.event_data.id.process_tgid);
+                break;
+            case proc_event::PROC_EVENT_COMM:
+                if (ev.event_data.comm.process_pid == ev.event_data.comm.process_tgid) {
+                    out.changed.push_back(ev.event_data.comm.process_tgid);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+} // namespace FrogKill
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace FrogKill {
+
+// Subscription to the kernel proc connector (NETLINK_CONNECTOR, CN_IDX_PROC):
+// fork/exec/exit/uid/comm notifications for every process on the system.
+// Listening requires CAP_NET_ADMIN; open() fails cleanly without it.
+//
+// Only process-level events are reported (thread creation is ignored).
+// Exits are not reported either: a process stays visible until it is
+// reaped, which the caller notices when its stat file disappears.
+// Qt-free; the socket is non-blocking and drained once per sampler tick.
+class ProcEvents {
+public:
+    struct Batch {
+        std::vector<int> added;     // fork: new process
+        std::vector<int> changed;   // exec, setuid, comm: metadata is stale
+        bool overflow{false};       // events were lost; the caller must resync
+    };
+
+    ProcEvents() = default;
+    ~ProcEvents();
+    ProcEvents(const ProcEvents&) = delete;
+    ProcEvents& operator=(const ProcEvents&) = delete;
+
+    // Subscribes and waits (briefly) for the kernel's acknowledgement.
+    bool open();
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    // Appends every pending event to `out` (whose vectors are not cleared).
+    void drain(Batch& out);
+
+private:
+    bool sendListen(bool listen);
+
+    int m_fd{-1};
+    alignas(8) char m_buf[16 * 1024];
+};
+
+} // namespace FrogKill
@@ -0,0 +1,248 @@
+#include "proc_filter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace FrogKill {
+
+static constexpr char kFieldSep = '\x1f';
+static constexpr char kRowSep = '\n';
+
+static char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+static void appendLower(std::vector<char>& out, std::string_view s) {
+    for (const char c : s) out.push_back(lower(c));
+}
+
+static bool contains(std::string_view hay, std::string_view needle) {
+    return ::memmem(hay.data(), hay.size(), needle.data(), needle.size()) != nullptr;
+}
+
+// Number with an optional size suffix (k, m, g, t; "kb"/"kib" spellings
+// too), in MiB. Plain numbers are returned as is.
+static bool parseNumber(std::string_view s, bool sizeUnits, double& out) {
+    const char* end = s.data() + s.size();
+    const auto [p, ec] = std::from_chars(s.data(), end, out);
+    if (ec != std::errc() || p == s.data()) return false;
+    std::string_view unit(p, (size_t)(end - p));
+    if (unit.empty()) return true;
+    if (!sizeUnits) return false;
+    if (unit.ends_with("ib")) unit.remove_suffix(2);
+    else if (unit.ends_with('b')) unit.remove_suffix(1);
+    if (unit == "k") out /= 1024.0;
+    else if (unit == "m") {}
+    else if (unit == "g") out *= 1024.0;
+    else if (unit == "t") out *= 1024.0 * 1024.0;
+    else return false;
+    return true;
+}
+
+bool ProcFilter::parseTerm(std::string_view token, Term& out) {
+    static constexpr struct { std::string_view name; Field field; } kFields[] = {
+        {"name", Field::Name}, {"user", Field::User}, {"ppid", Field::Ppid}, {"pid", Field::Pid},
+        {"cpu", Field::Cpu}, {"rss", Field::Rss}, {"mem", Field::Rss}, {"ram", Field::Rss},
+    };
+
+    for (const auto& f : kFields) {
+        if (!token.starts_with(f.name) || token.size() == f.name.size()) continue;
+        std::string_view rest = token.substr(f.name.size());
+
+        Op op;
+        if (rest.starts_with(">=")) op = Op::Ge;
+        else if (rest.starts_with("<=")) op = Op::Le;
+        else if (rest[0] == '>') op = Op::Gt;
+        else if (rest[0] == '<') op = Op::Lt;
+        else if (rest[0] == '=' || rest[0] == ':') op = Op::Eq;
+        else continue;   // e.g. "username": plain text
+        rest.remove_prefix(op == Op::Ge || op == Op::Le ? 2 : 1);
+
+        out.field = f.field;
+        out.text.clear();
+        if (f.field == Field::Name || f.field == Field::User) {
+            if (op != Op::Eq || rest.empty()) return false;
+            out.op = Op::Contains;
+            out.text.assign(rest);
+            return true;
+        }
+        out.op = op;
+        return parseNumber(rest, f.field == Field::Rss, out.value);
+    }
+
+    out.field = Field::Any;
+    out.op = Op::Contains;
+    out.text.assign(token);
+    return true;
+}
+
+bool ProcFilter::setQuery(std::string_view query) {
+    std::string lowered(query);
+    for (char& c : lowered) c = lower(c);
+
+    std::vector<Term> terms;
+    size_t i = 0;
+    while (i < lowered.size()) {
+        while (i < lowered.size() && (unsigned char)lowered[i] <= ' ') ++i;
+        size_t j = i;
+        while (j < lowered.size() && (unsigned char)lowered[j] > ' ') ++j;
+        Term term;
+        if (j > i && parseTerm(std::string_view(lowered).substr(i, j - i), term)) {
+            terms.push_back(std::move(term));
+        }
+        i = j;
+    }
+    if (terms == m_terms) return false;
+    m_terms = std::move(terms);
+    return true;
+}
+
+bool ProcFilter::implies(const std::vector<Term>& stricter, const std::vector<Term>& looser) {
+    for (const Term& old : looser) {
+        const bool covered = std::any_of(stricter.begin(), stricter.end(), [&](const Term& t) {
+            if (t.field != old.field || t.op != old.op) return false;
+            switch (t.op) {
+            case Op::Contains: return t.text.find(old.text) != std::string::npos;
+            case Op::Eq: return t.value == old.value;
+            case Op::Lt:
+            case Op::Le: return t.value <= old.value;
+            case Op::Gt:
+            case Op::Ge: return t.value >= old.value;
+            }
+            return false;
+        });
+        if (!covered) return false;
+    }
+    return true;
+}
+
+void ProcFilter::buildHaystack(const ProcTable& t) {
+    const size_t n = t.size();
+    m_text.clear();
+    m_off.resize(n + 1);
+    char pid[16];
+    for (size_t r = 0; r < n; ++r) {
+        m_off[r] = (uint32_t)m_text.size();
+        appendLower(m_text, t.name(r));
+        m_text.push_back(kFieldSep);
+        const auto res = std::to_chars(pid, pid + sizeof(pid), t.pid[r]);
+        m_text.insert(m_text.end(), pid, res.ptr);
+        m_text.push_back(kFieldSep);
+        appendLower(m_text, t.user(r));
+        m_text.push_back(kRowSep);
+    }
+    m_off[n] = (uint32_t)m_text.size();
+    m_haveText = true;
+}
+
+void ProcFilter::scanAll(std::string_view needle) {
+    // Needles have no bytes <= ' ' (the query is split there), so a hit
+    // never spans a row separator; after one, the search resumes at the
+    // next row.
+    m_rows.clear();
+    const char* base = m_text.data();
+    const size_t end = m_text.size();
+    size_t pos = 0;
+    uint32_t r = 0;
+    while (pos < end) {
+        const void* hit = ::memmem(base + pos, end - pos, needle.data(), needle.size());
+        if (!hit) break;
+        const size_t at = (size_t)((const char*)hit - base);
+        while (m_off[r + 1] <= at) ++r;
+        m_rows.push_back(r);
+        pos = m_off[r + 1];
+    }
+}
+
+void ProcFilter::narrow(const ProcTable& t, const Term& term) {
+    auto keep = [&](auto&& pred) {
+        m_rows.erase(std::remove_if(m_rows.begin(), m_rows.end(), [&](uint32_t r) { return !pred(r); }),
+                     m_rows.end());
+    };
+    auto compare = [&term](double v) {
+        switch (term.op) {
+        case Op::Eq: return v == term.value;
+        case Op::Lt: return v < term.value;
+        case Op::Le: return v <= term.value;
+        case Op::Gt: return v > term.value;
+        case Op::Ge: return v >= term.value;
+        case Op::Contains: break;
+        }
+        return false;
+    };
+
+    switch (term.field) {
+    case Field::Any:
+        keep([&](uint32_t r) {
+            return contains({m_text.data() + m_off[r], m_off[r + 1] - m_off[r]}, term.text);
+        });
+        break;
+    case Field::Name:
+        // The name is the first field of the row's haystack.
+        keep([&](uint32_t r) { return contains({m_text.data() + m_off[r], t.nameLen[r]}, term.text); });
+        break;
+    case Field::User:
+        // Users are interned per table: test each one once.
+        m_userHit.assign(m_userHit.size(), -1);
+        keep([&](uint32_t r) {
+            const uint32_t u = t.userIdx[r];
+            if (u >= m_userHit.size()) m_userHit.resize(u + 1, -1);
+            if (m_userHit[u] < 0) {
+                std::string name(t.user(r));
+                for (char& c : name) c = lower(c);
+                m_userHit[u] = contains(name, term.text) ? 1 : 0;
+            }
+            return m_userHit[u] == 1;
+        });
+        break;
+    case Field::Pid: keep([&](uint32_t r) { return compare(t.pid[r]); }); break;
+    case Field::Ppid: keep([&](uint32_t r) { return compare(t.ppid[r]); }); break;
+    case Field::Cpu: keep([&](uint32_t r) { return compare(t.cpuPercent[r]); }); break;
+    case Field::Rss: keep([&](uint32_t r) { return compare(t.rssMiB[r]); }); break;
+    }
+}
+
+void ProcFilter::apply(const ProcTable& t, unsigned long long seq) {
+    if (!active()) return;
+    const size_t n = t.size();
+    const bool sameTable = m_haveResult && seq == m_seq && m_match.size() == n;
+    if (sameTable && m_applied == m_terms) return;
+    if (!sameTable) m_haveText = false;
+    m_seq = seq;
+
+    const bool needText = std::any_of(m_terms.begin(), m_terms.end(), [](const Term& term) {
+        return term.field == Field::Any || term.field == Field::Name;
+    });
+    if (needText && !m_haveText) buildHaystack(t);
+
+    // Narrowing keeps m_rows and re-tests only those; otherwise seed them
+    // from the first plain-text term (a whole-buffer scan) or every row.
+    const Term* seeded = nullptr;
+    if (!(sameTable && implies(m_terms, m_applied))) {
+        const auto first = std::find_if(m_terms.begin(), m_terms.end(),
+                                        [](const Term& term) { return term.field == Field::Any; });
+        if (first != m_terms.end()) {
+            seeded = &*first;
+            scanAll(first->text);
+        } else {
+            m_rows.resize(n);
+            for (uint32_t r = 0; r < (uint32_t)n; ++r) m_rows[r] = r;
+        }
+    }
+
+    // Numeric terms first: they are the cheapest.
+    for (const Term& term : m_terms) {
+        if (&term != seeded && term.op != Op::Contains) narrow(t, term);
+    }
+    for (const Term& term : m_terms) {
+        if (&term != seeded && term.op == Op::Contains) narrow(t, term);
+    }
+
+    m_match.assign(n, 0);
+    for (const uint32_t r : m_rows) m_match[r] = 1;
+    m_applied = m_terms;
+    m_haveResult = true;
+}
+
+} // namespace FrogKill
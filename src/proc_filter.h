@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "proc_table.h"
+
+namespace FrogKill {
+
+// Filter engine for the process views (Qt-free).
+//
+// A query is a whitespace-separated list of terms that must all match:
+//   firefox          name, PID or user contains "firefox"
+//   name:fire        name contains        user:root   user contains
+//   pid:1234         PID equals           ppid:1      parent PID equals
+//   cpu>50 cpu<=1    CPU % comparisons    rss>1G      RSS, in MiB unless
+//   pid>1000                                          suffixed K/M/G/T
+// Matching is case-insensitive for ASCII. A term that is still being typed
+// (`cpu>`, `pid:12x`) is ignored rather than matching nothing.
+//
+// Text terms run memmem over one contiguous, pre-lowercased haystack per
+// table (one call per match, not per row). Numeric terms read the table's
+// columns directly. When the query only got stricter (typing more of it),
+// apply() re-tests just the previous matches.
+class ProcFilter {
+public:
+    // Returns true if the parsed query differs from the previous one.
+    bool setQuery(std::string_view query);
+    bool active() const { return !m_terms.empty(); }
+
+    // Evaluates the query against `t`. `seq` identifies the table contents
+    // (Snapshot::seq): the haystack and the narrowing shortcut are only
+    // reused for the same one.
+    void apply(const ProcTable& t, unsigned long long seq);
+
+    // Row of the last applied table passes (everything does when inactive).
+    bool accepts(size_t row) const {
+        return !active() || (row < m_match.size() && m_match[row]);
+    }
+    size_t matchCount() const { return m_rows.size(); }
+
+private:
+    enum class Field : uint8_t { Any, Name, User, Pid, Ppid, Cpu, Rss };
+    enum class Op : uint8_t { Contains, Eq, Lt, Le, Gt, Ge };
+    struct Term {
+        Field field;
+        Op op;
+        std::string text;   // lowercased (Contains)
+        double value{0.0};  // numeric ops
+
+        bool operator==(const Term&) const = default;
+    };
+
+    static bool parseTerm(std::string_view token, Term& out);
+    // True if every row matching `stricter` also matches `looser`.
+    static bool implies(const std::vector<Term>& stricter, const std::vector<Term>& looser);
+
+    void buildHaystack(const ProcTable& t);
+    // m_rows = rows whose haystack contains `needle`.
+    void scanAll(std::string_view needle);
+    // Drops the rows of m_rows that fail `term`.
+    void narrow(const ProcTable& t, const Term& term);
+
+    std::vector<Term> m_terms;
+    std::vector<Term> m_applied;          // terms m_rows/m_match are for
+    unsigned long long m_seq{0};
+    bool m_haveResult{false};
+
+    // Lowercased "name \x1f pid \x1f user \n" per row; row r is
+    // m_text[m_off[r] .. m_off[r + 1]). Built on first use per table.
+    std::vector<char> m_text;
+    std::vector<uint32_t> m_off;
+    bool m_haveText{false};
+    std::vector<int8_t> m_userHit;        // scratch: per interned user, -1 = unknown
+
+    std::vector<uint32_t> m_rows;         // matching rows, ascending
+    std::vector<uint8_t> m_match;         // per row
+};
+
+} // namespace FrogKill
@@ -0,0 +1,141 @@
+#include "proc_history.h"
+
+#include <algorithm>
+
+namespace FrogKill {
+
+void ProcHistory::configure(size_t budgetBytes, unsigned samples) {
+    m_samples = std::max(samples, 2u);
+    // Everything a process can cost: both rings, its slot, its free-list
+    // entry and up to four hash entries (2 * capacity rounded up to a power
+    // of two: between 1/4 and 1/2 full when every slot is in use).
+    const size_t perProcess = 2 * m_samples * sizeof(float) + sizeof(Slot) + 5 * sizeof(uint32_t);
+    m_capacity = std::min<size_t>(budgetBytes / perProcess, kNone - 1);
+
+    size_t buckets = 1;
+    while (buckets < m_capacity * 2) buckets <<= 1;
+    std::vector<float>(m_capacity * 2 * m_samples).swap(m_pool);
+    std::vector<Slot>(m_capacity).swap(m_slots);
+    std::vector<uint32_t>(m_capacity ? buckets : 0).swap(m_hash);
+    m_free.clear();
+    m_free.shrink_to_fit();
+    m_free.reserve(m_capacity);
+    clear();
+}
+
+void ProcHistory::clear() {
+    std::fill(m_hash.begin(), m_hash.end(), kNone);
+    m_free.clear();
+    // Popped from the back: low slots first.
+    for (size_t s = m_capacity; s > 0; --s) {
+        m_slots[s - 1].pid = 0;
+        m_free.push_back((uint32_t)(s - 1));
+    }
+    m_used = 0;
+    m_rowSlot.clear();
+}
+
+size_t ProcHistory::home(int pid, unsigned long long startTime) const {
+    // Same mix as PidStateTable.
+    uint64_t h = (uint64_t)(uint32_t)pid * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)startTime * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    return (size_t)h & (m_hash.size() - 1);
+}
+
+uint32_t ProcHistory::find(int pid, unsigned long long startTime) const {
+    const size_t mask = m_hash.size() - 1;
+    for (size_t i = home(pid, startTime);; i = (i + 1) & mask) {
+        const uint32_t s = m_hash[i];
+        if (s == kNone) return kNone;
+        if (m_slots[s].pid == pid && m_slots[s].startTime == startTime) return s;
+    }
+}
+
+void ProcHistory::unlink(uint32_t slot) {
+    // Backward-shift deletion, as in PidStateTable::eraseAt().
+    const size_t mask = m_hash.size() - 1;
+    const Slot& victim = m_slots[slot];
+    size_t hole = home(victim.pid, victim.startTime);
+    while (m_hash[hole] != slot) hole = (hole + 1) & mask;
+    for (size_t j = (hole + 1) & mask; m_hash[j] != kNone; j = (j + 1) & mask) {
+        const Slot& s = m_slots[m_hash[j]];
+        const size_t k = home(s.pid, s.startTime);
+        const bool stays = (hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j);
+        if (stays) continue;
+        m_hash[hole] = m_hash[j];
+        hole = j;
+    }
+    m_hash[hole] = kNone;
+}
+
+void ProcHistory::append(uint32_t slot, float cpu, float rss) {
+    Slot& s = m_slots[slot];
+    float* ring = m_pool.data() + (size_t)slot * 2 * m_samples;
+    ring[s.head] = cpu;
+    ring[m_samples + s.head] = rss;
+    s.head = s.head + 1 == m_samples ? 0 : s.head + 1;
+    if (s.count < m_samples) ++s.count;
+    s.lastTick = m_tick;
+}
+
+void ProcHistory::update(const ProcTable& t) {
+    const size_t n = t.size();
+    if (!enabled()) {
+        m_rowSlot.clear();
+        return;
+    }
+    ++m_tick;
+
+    // 1) Known processes get their sample.
+    m_rowSlot.resize(n);
+    size_t seen = 0;
+    for (size_t r = 0; r < n; ++r) {
+        const uint32_t s = find(t.pid[r], t.startTime[r]);
+        m_rowSlot[r] = s;
+        if (s == kNone) continue;
+        append(s, (float)t.cpuPercent[r], (float)t.rssMiB[r]);
+        ++seen;
+    }
+
+    // 2) Rings of processes that are gone go back to the pool (nothing to
+    //    walk when every ring was updated).
+    if (seen != m_used) {
+        for (uint32_t s = 0; s < (uint32_t)m_capacity; ++s) {
+            Slot& slot = m_slots[s];
+            if (slot.pid == 0 || slot.lastTick == m_tick) continue;
+            unlink(s);
+            slot.pid = 0;
+            m_free.push_back(s);
+            --m_used;
+        }
+    }
+
+    // 3) New processes take free rings while there are any.
+    const size_t mask = m_hash.size() - 1;
+    for (size_t r = 0; r < n && !m_free.empty(); ++r) {
+        if (m_rowSlot[r] != kNone) continue;
+        const uint32_t s = m_free.back();
+        m_free.pop_back();
+        Slot& slot = m_slots[s];
+        slot.pid = t.pid[r];
+        slot.startTime = t.startTime[r];
+        slot.head = 0;
+        slot.count = 0;
+        size_t i = home(slot.pid, slot.startTime);
+        while (m_hash[i] != kNone) i = (i + 1) & mask;
+        m_hash[i] = s;
+        ++m_used;
+        m_rowSlot[r] = s;
+        append(s, (float)t.cpuPercent[r], (float)t.rssMiB[r]);
+    }
+}
+
+ProcHistory::Series ProcHistory::series(uint32_t slot) const {
+    if (slot >= m_capacity || m_slots[slot].pid == 0) return {};
+    const Slot& s = m_slots[slot];
+    const float* ring = m_pool.data() + (size_t)slot * 2 * m_samples;
+    return {ring, ring + m_samples, m_samples, (s.head + m_samples - s.count) % m_samples, s.count};
+}
+
+} // namespace FrogKill
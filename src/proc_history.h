@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "proc_table.h"
+
+namespace FrogKill {
+
+// Recent CPU and RSS of every process, for the history sparklines.
+//
+// Each process generation (pid, starttime) owns a ring of the last
+// samples() values in one pool allocated by configure(); the ring of a
+// process that exits goes to the next new one. The pool is sized by a byte
+// budget, not by the process count: when it is full, new processes get no
+// history until others exit. update() costs O(1) per process and does not
+// allocate once the row count has peaked.
+class ProcHistory {
+public:
+    static constexpr uint32_t kNone = ~0u;
+
+    // One process's ring; index 0 is the oldest sample.
+    struct Series {
+        const float* cpu{nullptr};
+        const float* rss{nullptr};
+        unsigned capacity{0};
+        unsigned first{0};      // ring position of the oldest sample
+        unsigned count{0};
+
+        float cpuAt(unsigned i) const { return cpu[(first + i) % capacity]; }
+        float rssAt(unsigned i) const { return rss[(first + i) % capacity]; }
+    };
+
+    // Drops all history and reallocates the pool: as many rings of
+    // `samples` values as fit in `budgetBytes` (0 turns history off).
+    void configure(size_t budgetBytes, unsigned samples);
+    void clear();
+
+    bool enabled() const { return m_capacity > 0; }
+    unsigned samples() const { return m_samples; }
+    // Processes the pool can hold, and how many it holds now.
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_used; }
+
+    // Appends one sample for every row of `t` and frees the rings of
+    // processes no longer in it.
+    void update(const ProcTable& t);
+
+    // Ring of row `row` of the table last passed to update(), or kNone.
+    uint32_t slotOfRow(size_t row) const { return row < m_rowSlot.size() ? m_rowSlot[row] : kNone; }
+    Series series(uint32_t slot) const;
+
+private:
+    struct Slot {
+        int pid;                          // 0 = free
+        unsigned long long startTime;
+        unsigned head;                    // next write position
+        unsigned count;
+        unsigned lastTick;
+    };
+
+    size_t home(int pid, unsigned long long startTime) const;
+    uint32_t find(int pid, unsigned long long startTime) const;
+    void unlink(uint32_t slot);
+    void append(uint32_t slot, float cpu, float rss);
+
+    unsigned m_samples{0};
+    size_t m_capacity{0};
+    size_t m_used{0};
+    unsigned m_tick{0};
+
+    // Ring s: CPU at [2s * samples, (2s + 1) * samples), RSS right after.
+    std::vector<float> m_pool;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_hash;         // open addressing, slot numbers
+    std::vector<uint32_t> m_free;         // free slot numbers (a stack)
+    std::vector<uint32_t> m_rowSlot;      // per row of the last table
+};
+
+} // namespace FrogKill
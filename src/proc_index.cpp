@@ -0,0 +1,95 @@
+#include "proc_index.h"
+
+#include <algorithm>
+
+namespace FrogKill {
+
+void ProcIndex::clear() {
+    m_byPid.clear();
+    m_parent.clear();
+    m_offset.clear();
+    m_child.clear();
+    m_roots.clear();
+    m_preorder.clear();
+    m_pos.clear();
+    m_size.clear();
+    m_cpu.clear();
+    m_rss.clear();
+}
+
+uint32_t ProcIndex::rowOf(int pid) const {
+    const auto it = std::lower_bound(m_byPid.begin(), m_byPid.end(), pid,
+                                     [](const std::pair<int, uint32_t>& e, int p) { return e.first < p; });
+    return it != m_byPid.end() && it->first == pid ? it->second : kNone;
+}
+
+void ProcIndex::build(const ProcTable& t) {
+    clear();
+    const uint32_t n = (uint32_t)t.size();
+
+    // The sampler emits rows in PID order, so this is usually just the
+    // is_sorted() pass.
+    m_byPid.resize(n);
+    for (uint32_t r = 0; r < n; ++r) m_byPid[r] = {t.pid[r], r};
+    if (!std::is_sorted(m_byPid.begin(), m_byPid.end())) std::sort(m_byPid.begin(), m_byPid.end());
+
+    m_parent.resize(n);
+    for (uint32_t r = 0; r < n; ++r) {
+        const int ppid = t.ppid[r];
+        m_parent[r] = ppid > 0 && ppid != t.pid[r] ? rowOf(ppid) : kNone;
+    }
+
+    // Break PPID cycles: follow each parent chain once (m_pos holds the
+    // walk state: kNone = unseen, 1 = on the current chain, 2 = done).
+    m_pos.assign(n, kNone);
+    for (uint32_t r = 0; r < n; ++r) {
+        m_stack.clear();
+        uint32_t x = r;
+        while (x != kNone && m_pos[x] == kNone) {
+            m_pos[x] = 1;
+            m_stack.push_back(x);
+            x = m_parent[x];
+        }
+        if (x != kNone && m_pos[x] == 1) m_parent[x] = kNone;
+        for (const uint32_t y : m_stack) m_pos[y] = 2;
+    }
+
+    // CSR children, in PID order.
+    m_offset.assign((size_t)n + 1, 0);
+    for (uint32_t r = 0; r < n; ++r) {
+        if (m_parent[r] != kNone) ++m_offset[m_parent[r] + 1];
+    }
+    for (uint32_t r = 0; r < n; ++r) m_offset[r + 1] += m_offset[r];
+    m_child.resize(m_offset[n]);
+    m_stack.assign(m_offset.begin(), m_offset.end() - 1);   // fill cursors
+    for (const auto& [pid, r] : m_byPid) {
+        if (m_parent[r] == kNone) m_roots.push_back(r);
+        else m_child[m_stack[m_parent[r]]++] = r;
+    }
+
+    // Preorder (iterative DFS; children pushed in reverse to pop in PID order).
+    m_preorder.reserve(n);
+    m_stack.clear();
+    for (auto it = m_roots.rbegin(); it != m_roots.rend(); ++it) m_stack.push_back(*it);
+    while (!m_stack.empty()) {
+        const uint32_t r = m_stack.back();
+        m_stack.pop_back();
+        m_pos[r] = (uint32_t)m_preorder.size();
+        m_preorder.push_back(r);
+        for (uint32_t k = m_offset[r + 1]; k > m_offset[r]; --k) m_stack.push_back(m_child[k - 1]);
+    }
+
+    // Subtree sizes and sums, children before parents.
+    m_size.assign(n, 1);
+    m_cpu.assign(t.cpuPercent.begin(), t.cpuPercent.end());
+    m_rss.assign(t.rssMiB.begin(), t.rssMiB.end());
+    for (auto it = m_preorder.rbegin(); it != m_preorder.rend(); ++it) {
+        const uint32_t p = m_parent[*it];
+        if (p == kNone) continue;
+        m_size[p] += m_size[*it];
+        m_cpu[p] += m_cpu[*it];
+        m_rss[p] += m_rss[*it];
+    }
+}
+
+} // namespace FrogKill
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "proc_table.h"
+
+namespace FrogKill {
+
+// Parent/child structure of one ProcTable, built once per snapshot on the
+// sampler thread (Qt-free).
+//
+// Children are stored CSR-style, sorted by PID: those of row r are
+// child[offset[r] .. offset[r + 1]). Rows are also laid out in preorder,
+// so the subtree of r is one contiguous range and subtree queries cost a
+// lookup plus O(subtree). A row whose parent is not in the table is a
+// root (as is one PPID of a cycle that a racy scan with PID reuse can
+// produce). Like ProcTable, clear() keeps every buffer's capacity.
+class ProcIndex {
+public:
+    static constexpr uint32_t kNone = ~0u;
+
+    void clear();
+    void build(const ProcTable& t);
+
+    size_t size() const { return m_parent.size(); }
+
+    // Row of `pid`, or kNone.
+    uint32_t rowOf(int pid) const;
+    // Parent row, or kNone for a root.
+    uint32_t parent(uint32_t row) const { return m_parent[row]; }
+    std::span<const uint32_t> children(uint32_t row) const {
+        return {m_child.data() + m_offset[row], m_offset[row + 1] - m_offset[row]};
+    }
+    std::span<const uint32_t> roots() const { return m_roots; }
+
+    // Every row, parents before their children (root subtrees in PID order).
+    std::span<const uint32_t> preorder() const { return m_preorder; }
+    // `row` followed by all its descendants, parents first; walk it
+    // backwards for a children-before-parents (kill) order.
+    std::span<const uint32_t> subtree(uint32_t row) const {
+        return {m_preorder.data() + m_pos[row], m_size[row]};
+    }
+    uint32_t subtreeSize(uint32_t row) const { return m_size[row]; }
+    // Sums over the subtree of `row`, itself included.
+    double subtreeCpu(uint32_t row) const { return m_cpu[row]; }
+    double subtreeRss(uint32_t row) const { return m_rss[row]; }
+
+private:
+    std::vector<std::pair<int, uint32_t>> m_byPid;   // sorted by PID
+    std::vector<uint32_t> m_parent;
+    std::vector<uint32_t> m_offset;                  // size() + 1 entries
+    std::vector<uint32_t> m_child;
+    std::vector<uint32_t> m_roots;
+    std::vector<uint32_t> m_preorder;
+    std::vector<uint32_t> m_pos;                     // row -> index in m_preorder
+    std::vector<uint32_t> m_size;
+    std::vector<double> m_cpu;
+    std::vector<double> m_rss;
+    std::vector<uint32_t> m_stack;                   // scratch
+};
+
+} // namespace FrogKill
@@ -0,0 +1,206 @@
+#include "proc_kill.h"
+#include "proc_scanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Same numbers on every architecture; older libc headers lack them.
+#ifndef __NR_pidfd_open
+#define __NR_pidfd_open 434
+#endif
+#ifndef __NR_pidfd_send_signal
+#define __NR_pidfd_send_signal 424
+#endif
+
+namespace FrogKill {
+
+using Clock = std::chrono::steady_clock;
+
+// How long terminateAll() waits for SIGKILL to take effect.
+static constexpr int kKillWaitMs = 2000;
+// Poll interval when there is no pidfd to wait on.
+static constexpr int kFallbackPollMs = 20;
+
+static bool readStat(int pid, StatFields& st) {
+    char path[32] = "/proc/";
+    char* p = std::to_chars(path + 6, path + sizeof(path) - 6, pid).ptr;
+    std::memcpy(p, "/stat", 6);
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[1024];
+    ssize_t n;
+    do {
+        n = ::read(fd, buf, sizeof(buf));
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    return n > 0 && parseStatLine(buf, (size_t)n, st);
+}
+
+bool readStartTime(int pid, unsigned long long& startTime) {
+    StatFields st;
+    if (!readStat(pid, st)) return false;
+    startTime = st.startTime;
+    return true;
+}
+
+ProcHandle::~ProcHandle() {
+    close();
+}
+
+ProcHandle::ProcHandle(ProcHandle&& other) noexcept
+    : m_pid(other.m_pid), m_fd(other.m_fd), m_startTime(other.m_startTime) {
+    other.m_pid = 0;
+    other.m_fd = -1;
+}
+
+ProcHandle& ProcHandle::operator=(ProcHandle&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_pid = other.m_pid;
+        m_fd = other.m_fd;
+        m_startTime = other.m_startTime;
+        other.m_pid = 0;
+        other.m_fd = -1;
+    }
+    return *this;
+}
+
+int ProcHandle::open(int pid, unsigned long long startTime) {
+    close();
+    if (pid <= 0) return EINVAL;
+
+    // Take the pidfd first, then check the generation: if the check passes,
+    // the fd refers to the sampled process even if it dies right after.
+    int fd = (int)::syscall(__NR_pidfd_open, pid, 0);
+    if (fd < 0 && errno != ENOSYS) return errno;
+
+    unsigned long long actual = 0;
+    if (!readStartTime(pid, actual) || (startTime != 0 && actual != startTime)) {
+        if (fd >= 0) ::close(fd);
+        return ESRCH;
+    }
+    m_pid = pid;
+    m_fd = fd;
+    m_startTime = actual;
+    return 0;
+}
+
+void ProcHandle::close() {
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_pid = 0;
+}
+
+int ProcHandle::signal(int sig) const {
+    if (m_pid <= 0) return ESRCH;
+    if (m_fd >= 0) {
+        if (::syscall(__NR_pidfd_send_signal, m_fd, sig, nullptr, 0) == 0) return 0;
+        return errno;
+    }
+    // No pidfd: re-check the generation right before kill(). The window is
+    // tiny, but not zero.
+    if (exited()) return ESRCH;
+    return ::kill(m_pid, sig) == 0 ? 0 : errno;
+}
+
+bool ProcHandle::exited() const {
+    if (m_pid <= 0) return true;
+    if (m_fd >= 0) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        return ::poll(&pfd, 1, 0) > 0;
+    }
+    StatFields st;
+    return !readStat(m_pid, st) || st.startTime != m_startTime || st.state == 'Z' || st.state == 'X';
+}
+
+bool ProcHandle::waitExit(int timeoutMs) const {
+    if (m_pid <= 0) return true;
+    if (m_fd >= 0) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            int left = timeoutMs;
+            if (timeoutMs >= 0) {
+                left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+                if (left < 0) left = 0;
+            }
+            const int r = ::poll(&pfd, 1, left);
+            if (r > 0) return true;
+            if (r == 0) return false;
+            if (errno != EINTR) return exited();
+        }
+    }
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!exited()) {
+        if (timeoutMs >= 0 && Clock::now() >= deadline) return false;
+        ::usleep(kFallbackPollMs * 1000);
+    }
+    return true;
+}
+
+size_t waitAllExit(const std::vector<ProcHandle>& handles, int timeoutMs) {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::vector<pollfd> fds;
+    fds.reserve(handles.size());
+    for (;;) {
+        size_t running = 0;
+        bool fallback = false;
+        fds.clear();
+        for (const auto& h : handles) {
+            if (h.exited()) continue;
+            ++running;
+            if (h.fd() >= 0) fds.push_back({h.fd(), POLLIN, 0});
+            else fallback = true;
+        }
+        if (running == 0) return 0;
+
+        int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (left <= 0) return running;
+        // Without pidfds we can only poll; with them, any exit wakes us up.
+        if (fallback) left = std::min(left, kFallbackPollMs);
+        if (fds.empty()) ::usleep(left * 1000);
+        else ::poll(fds.data(), fds.size(), left);
+    }
+}
+
+size_t terminateEach(const std::vector<ProcHandle>& handles, int sig, int graceMs, std::vector<int>& errors) {
+    errors.assign(handles.size(), 0);
+    for (size_t i = 0; i < handles.size(); ++i) {
+        errors[i] = handles[i].signal(sig);
+    }
+    if (graceMs <= 0) return waitAllExit(handles, 0);
+    if (sig != SIGTERM) return waitAllExit(handles, std::max(graceMs, kKillWaitMs));
+    if (waitAllExit(handles, graceMs) == 0) return 0;
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (handles[i].exited()) continue;
+        const int e = handles[i].signal(SIGKILL);
+        if (e != 0 && e != ESRCH && errors[i] == 0) errors[i] = e;
+    }
+    return waitAllExit(handles, kKillWaitMs);
+}
+
+size_t terminateAll(const std::vector<ProcHandle>& handles, int sig, int graceMs, int& firstError) {
+    std::vector<int> errors;
+    const size_t running = terminateEach(handles, sig, graceMs, errors);
+    firstError = 0;
+    for (const int e : errors) {
+        if (e != 0 && e != ESRCH) {
+            firstError = e;
+            break;
+        }
+    }
+    return running;
+}
+
+} // namespace FrogKill
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace FrogKill {
+
+// Signal delivery bound to one process generation. Shared by the GUI and
+// frogkill-helper, so it must stay Qt-free.
+//
+// A handle is a pidfd (pidfd_open, Linux >= 5.3) taken on a PID whose
+// starttime is then checked against the sampled one: if the PID was reused
+// in the meantime open() fails with ESRCH, and once open the handle can
+// never signal a different process. On older kernels it degrades to plain
+// kill() after the same starttime check.
+
+// starttime (field 22 of /proc/<pid>/stat). False if the PID is gone.
+bool readStartTime(int pid, unsigned long long& startTime);
+
+class ProcHandle {
+public:
+    ProcHandle() = default;
+    ~ProcHandle();
+    ProcHandle(ProcHandle&& other) noexcept;
+    ProcHandle& operator=(ProcHandle&& other) noexcept;
+    ProcHandle(const ProcHandle&) = delete;
+    ProcHandle& operator=(const ProcHandle&) = delete;
+
+    // Binds to `pid` if it is still the generation started at `startTime`
+    // (0 = whatever currently runs under that PID). Returns 0 or an errno
+    // value; ESRCH means gone or reused.
+    int open(int pid, unsigned long long startTime);
+    void close();
+
+    bool isOpen() const { return m_pid > 0; }
+    int pid() const { return m_pid; }
+    // The pidfd (readable once the process exits), or -1 without pidfd support.
+    int fd() const { return m_fd; }
+
+    // Returns 0 or an errno value (ESRCH once the process has exited).
+    int signal(int sig) const;
+    // True once the process has exited; an unreaped zombie counts as exited.
+    bool exited() const;
+    // Waits up to `timeoutMs` (-1 = forever). True if the process exited.
+    bool waitExit(int timeoutMs) const;
+
+private:
+    int m_pid{0};
+    int m_fd{-1};
+    unsigned long long m_startTime{0};
+};
+
+// Waits until every handle has exited or `timeoutMs` elapsed. Returns the
+// number still running.
+size_t waitAllExit(const std::vector<ProcHandle>& handles, int timeoutMs);
+
+// Sends `sig` to all handles in order. With graceMs <= 0 it returns right
+// away; otherwise it waits for the exits, and for SIGTERM the ones still
+// running after graceMs get SIGKILL (then a short final wait). Returns the
+// number still running; `firstError` receives the first signal errno other
+// than ESRCH.
+size_t terminateAll(const std::vector<ProcHandle>& handles, int sig, int graceMs, int& firstError);
+
+// Like terminateAll(), but reports the signal errno of every handle in
+// `errors` (ESRCH included); all handles share one grace period.
+size_t terminateEach(const std::vector<ProcHandle>& handles, int sig, int graceMs, std::vector<int>& errors);
+
+} // namespace FrogKill
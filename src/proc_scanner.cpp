@@ -0,0 +1,243 @@
+#include "proc_scanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+namespace {
+
+// Layout returned by getdents64 (glibc does not export it).
+struct LinuxDirent64 {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+bool parsePidName(const char* s, int& pid) {
+    if (*s < '1' || *s > '9') return false;
+    int v = 0;
+    for (; *s; ++s) {
+        if (*s < '0' || *s > '9') return false;
+        v = v * 10 + (*s - '0');
+    }
+    pid = v;
+    return true;
+}
+
+// Appends the numeric entries of directory `fd` (read from its current
+// offset) to `out`, using `buf` for getdents64.
+bool readNumericEntries(int fd, char* buf, size_t cap, std::vector<int>& out) {
+    for (;;) {
+        const long n = ::syscall(SYS_getdents64, fd, buf, cap);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return true;
+        for (long off = 0; off < n;) {
+            const auto* d = reinterpret_cast<const LinuxDirent64*>(buf + off);
+            off += d->d_reclen;
+            if (d->d_type != DT_DIR && d->d_type != DT_UNKNOWN) continue;
+            int pid = 0;
+            if (parsePidName(d->d_name, pid)) out.push_back(pid);
+        }
+    }
+}
+
+inline void skipSpaces(const char*& p, const char* end) {
+    while (p < end && *p == ' ') ++p;
+}
+
+inline void skipField(const char*& p, const char* end) {
+    while (p < end && *p != ' ') ++p;
+    skipSpaces(p, end);
+}
+
+inline bool parseNum(const char*& p, const char* end, long long& out) {
+    const auto r = std::from_chars(p, end, out);
+    if (r.ec != std::errc{}) return false;
+    p = r.ptr;
+    skipSpaces(p, end);
+    return true;
+}
+
+} // namespace
+
+ProcDir::~ProcDir() {
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+bool ProcDir::open(const char* root) {
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = ::open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    return m_fd >= 0;
+}
+
+bool ProcDir::listPids(std::vector<int>& out) {
+    out.clear();
+    if (m_fd < 0) return false;
+    if (::lseek(m_fd, 0, SEEK_SET) < 0) return false;
+    return readNumericEntries(m_fd, m_buf, sizeof(m_buf), out);
+}
+
+bool parseStatLine(const char* buf, size_t len, StatFields& out) {
+    const char* end = buf + len;
+    const char* lpar = static_cast<const char*>(std::memchr(buf, '(', len));
+    const char* rpar = nullptr;
+    for (const char* q = end; q > buf; --q) {
+        if (q[-1] == ')') { rpar = q - 1; break; }
+    }
+    if (!lpar || !rpar || rpar <= lpar) return false;
+
+    const size_t commLen = std::min<size_t>((size_t)(rpar - lpar - 1), sizeof(out.comm) - 1);
+    std::memcpy(out.comm, lpar + 1, commLen);
+    out.comm[commLen] = '\0';
+    out.commLen = (int)commLen;
+
+    // After ") ": state(3) ppid(4) ... flags(9) ... utime(14) stime(15) ... starttime(22)
+    const char* p = rpar + 1;
+    skipSpaces(p, end);
+    if (p >= end) return false;
+    out.state = *p;
+    skipField(p, end);
+
+    long long v = 0;
+    if (!parseNum(p, end, v)) return false;
+    out.ppid = (int)v;
+    for (int field = 5; field < 9; ++field) skipField(p, end);
+    if (!parseNum(p, end, v)) return false;
+    out.flags = (unsigned)v;
+    for (int field = 10; field < 14; ++field) skipField(p, end);
+    if (!parseNum(p, end, out.utime)) return false;
+    if (!parseNum(p, end, out.stime)) return false;
+    for (int field = 16; field < 22; ++field) skipField(p, end);
+    long long start = 0;
+    if (!parseNum(p, end, start)) return false;
+    out.startTime = (unsigned long long)start;
+    return true;
+}
+
+bool ProcReader::readRaw(const char* relPath, char* buf, size_t cap, size_t& len) {
+    len = 0;
+    const int fd = ::openat(m_dir->fd(), relPath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    ssize_t n;
+    do {
+        n = ::pread(fd, buf, cap, 0);
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    if (n < 0) return false;
+    len = (size_t)n;
+    return true;
+}
+
+bool ProcReader::formatPath(int pid, const char* leaf) {
+    // "<pid>/<leaf>" relative to the procfs dirfd, formatted without allocation.
+    char* p = m_path;
+    char* const end = m_path + sizeof(m_path) - 1;
+    p = std::to_chars(p, end, pid).ptr;
+    *p++ = '/';
+    const size_t leafLen = std::strlen(leaf);
+    if (p + leafLen > end) return false;
+    std::memcpy(p, leaf, leafLen);
+    p[leafLen] = '\0';
+    return true;
+}
+
+bool ProcReader::readPidFile(int pid, const char* leaf, char* buf, size_t cap, size_t& len) {
+    len = 0;
+    return formatPath(pid, leaf) && readRaw(m_path, buf, cap, len);
+}
+
+bool ProcReader::readStat(int pid, StatFields& out) {
+    size_t len = 0;
+    if (!readPidFile(pid, "stat", m_buf, sizeof(m_buf), len) || len == 0) return false;
+    return parseStatLine(m_buf, len, out);
+}
+
+bool ProcReader::listTasks(int pid, std::vector<int>& out) {
+    out.clear();
+    if (!formatPath(pid, "task")) return false;
+    const int fd = ::openat(m_dir->fd(), m_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    const bool ok = readNumericEntries(fd, m_dents, sizeof(m_dents), out);
+    ::close(fd);
+    return ok;
+}
+
+bool ProcReader::readTaskStat(int pid, int tid, StatFields& out) {
+    // Same line format as the process's stat, for one thread.
+    char leaf[32] = "task/";
+    char* p = std::to_chars(leaf + 5, leaf + sizeof(leaf) - 6, tid).ptr;
+    std::memcpy(p, "/stat", 6);
+    size_t len = 0;
+    if (!readPidFile(pid, leaf, m_buf, sizeof(m_buf), len) || len == 0) return false;
+    return parseStatLine(m_buf, len, out);
+}
+
+bool ProcReader::readRssPages(int pid, long long& pages) {
+    size_t len = 0;
+    if (!readPidFile(pid, "statm", m_buf, sizeof(m_buf), len) || len == 0) return false;
+    const char* p = m_buf;
+    const char* end = m_buf + len;
+    long long size = 0;
+    return parseNum(p, end, size) && parseNum(p, end, pages);
+}
+
+bool ProcReader::readUid(int pid, uid_t& uid) {
+    // "Uid:" is within the first few hundred bytes; one bounded read suffices.
+    size_t len = 0;
+    if (!readPidFile(pid, "status", m_buf, sizeof(m_buf), len) || len == 0) return false;
+    const char* end = m_buf + len;
+    for (const char* line = m_buf; line < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(line, '\n', (size_t)(end - line)));
+        const char* lineEnd = nl ? nl : end;
+        if (lineEnd - line > 4 && std::memcmp(line, "Uid:", 4) == 0) {
+            const char* p = line + 4;
+            while (p < lineEnd && (*p == ' ' || *p == '\t')) ++p;
+            long long ruid = 0;
+            if (std::from_chars(p, lineEnd, ruid).ec != std::errc{}) return false;
+            uid = (uid_t)ruid;
+            return true;
+        }
+        if (!nl) break;
+        line = nl + 1;
+    }
+    return false;
+}
+
+size_t ProcReader::readCmdline(int pid, const char*& out) {
+    out = m_cmdline;
+    size_t len = 0;
+    if (!readPidFile(pid, "cmdline", m_cmdline, sizeof(m_cmdline), len)) return 0;
+
+    // NUL-separated; map NULs (and other whitespace) to spaces, collapse runs
+    // and trim in a single in-place pass.
+    size_t w = 0;
+    bool pendingSpace = false;
+    for (size_t r = 0; r < len; ++r) {
+        const char ch = m_cmdline[r];
+        if (ch == '\0' || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+            pendingSpace = (w != 0);
+            continue;
+        }
+        if (pendingSpace) {
+            m_cmdline[w++] = ' ';
+            pendingSpace = false;
+        }
+        m_cmdline[w++] = ch;
+    }
+    return w;
+}
+
+} // namespace FrogKill
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <sys/types.h>
+
+namespace FrogKill {
+
+// Low-level /proc access used by the samplers.
+// Everything here is Qt-free, syscall-based and works on caller-owned or
+// fixed member buffers, so a steady-state scan does no heap allocation.
+
+// Persistent handle on the procfs root. PIDs are listed with getdents64 on
+// a directory fd that stays open between ticks (rewound with lseek).
+class ProcDir {
+public:
+    ProcDir() = default;
+    ~ProcDir();
+    ProcDir(const ProcDir&) = delete;
+    ProcDir& operator=(const ProcDir&) = delete;
+
+    bool open(const char* root = "/proc");
+    bool isOpen() const { return m_fd >= 0; }
+    int fd() const { return m_fd; }
+
+    // Replaces `out` with the numeric entries of the directory. Capacity of
+    // `out` is reused across calls.
+    bool listPids(std::vector<int>& out);
+
+private:
+    int m_fd{-1};
+    alignas(8) char m_buf[32 * 1024];
+};
+
+// Fields of /proc/[pid]/stat we actually use.
+struct StatFields {
+    char comm[64]{};
+    int commLen{0};
+    char state{0};
+    int ppid{0};
+    unsigned flags{0};                // PF_* (PF_KTHREAD = 0x00200000)
+    long long utime{0};
+    long long stime{0};
+    unsigned long long startTime{0};  // clock ticks after boot; (pid, startTime) identifies a process
+};
+
+// Hand-rolled parser for a stat line. comm may contain spaces and ')', so
+// the remaining fields are located from the LAST ')'.
+bool parseStatLine(const char* buf, size_t len, StatFields& out);
+
+// Per-thread reader: opens files relative to a ProcDir with openat() and
+// reads them into fixed buffers. Not thread-safe; give each thread its own.
+class ProcReader {
+public:
+    // Very long command lines (e.g. huge argument lists) are truncated.
+    static constexpr size_t kCmdlineCap = 4096;
+
+    explicit ProcReader(const ProcDir& dir) : m_dir(&dir) {}
+
+    bool readStat(int pid, StatFields& out);
+    // Thread IDs of a process (entries of <pid>/task), in directory order.
+    bool listTasks(int pid, std::vector<int>& out);
+    // stat of one thread, <pid>/task/<tid>/stat.
+    bool readTaskStat(int pid, int tid, StatFields& out);
+    // Resident set size in pages (second field of statm).
+    bool readRssPages(int pid, long long& pages);
+    // Real UID from the "Uid:" line; only the head of status is read.
+    bool readUid(int pid, uid_t& uid);
+    // Space-joined, trimmed and space-collapsed cmdline. Returns its length
+    // (0 for kernel threads/zombies); `out` points into an internal buffer
+    // valid until the next call.
+    size_t readCmdline(int pid, const char*& out);
+
+    // Reads up to `cap` bytes of a file relative to the procfs root.
+    bool readRaw(const char* relPath, char* buf, size_t cap, size_t& len);
+
+private:
+    bool formatPath(int pid, const char* leaf);
+    bool readPidFile(int pid, const char* leaf, char* buf, size_t cap, size_t& len);
+
+    const ProcDir* m_dir;
+    char m_path[64]{};
+    char m_buf[1024]{};
+    char m_cmdline[kCmdlineCap]{};
+    alignas(8) char m_dents[4096];
+};
+
+} // namespace FrogKill
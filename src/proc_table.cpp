@@ -0,0 +1,131 @@
+#include "proc_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace FrogKill {
+
+void ProcTable::clear() {
+    pid.clear();
+    ppid.clear();
+    startTime.clear();
+    cpuPercent.clear();
+    rssMiB.clear();
+    uid.clear();
+    nameOff.clear();
+    nameLen.clear();
+    userIdx.clear();
+    m_arena.clear();
+    m_users.clear();
+}
+
+void ProcTable::reserve(size_t rows, size_t arenaBytes) {
+    pid.reserve(rows);
+    ppid.reserve(rows);
+    startTime.reserve(rows);
+    cpuPercent.reserve(rows);
+    rssMiB.reserve(rows);
+    uid.reserve(rows);
+    nameOff.reserve(rows);
+    nameLen.reserve(rows);
+    userIdx.reserve(rows);
+    m_arena.reserve(arenaBytes);
+}
+
+int ProcTable::findUser(uid_t u) const {
+    // A handful of distinct users per host is the norm; a linear scan over
+    // a contiguous array beats hashing here.
+    for (size_t i = 0; i < m_users.size(); ++i) {
+        if (m_users[i].uid == u) return (int)i;
+    }
+    return -1;
+}
+
+uint32_t ProcTable::store(std::string_view s) {
+    const uint32_t off = (uint32_t)m_arena.size();
+    m_arena.insert(m_arena.end(), s.begin(), s.end());
+    return off;
+}
+
+uint32_t ProcTable::internUser(uid_t u, std::string_view name) {
+    const int found = findUser(u);
+    if (found >= 0) return (uint32_t)found;
+    m_users.push_back(User{u, store(name), (uint32_t)name.size()});
+    return (uint32_t)(m_users.size() - 1);
+}
+
+size_t ProcTable::append(int p, int pp, unsigned long long start,
+                         double cpu, double rss, uid_t u,
+                         std::string_view name, std::string_view user) {
+    pid.push_back(p);
+    ppid.push_back(pp);
+    startTime.push_back(start);
+    cpuPercent.push_back(cpu);
+    rssMiB.push_back(rss);
+    uid.push_back(u);
+    nameOff.push_back(store(name));
+    nameLen.push_back((uint32_t)name.size());
+    userIdx.push_back(internUser(u, user));
+    return pid.size() - 1;
+}
+
+void ProcTable::appendRow(const ProcTable& other, size_t row) {
+    append(other.pid[row], other.ppid[row], other.startTime[row],
+           other.cpuPercent[row], other.rssMiB[row], other.uid[row],
+           other.name(row), other.user(row));
+}
+
+void ProcTable::appendTable(const ProcTable& other) {
+    const size_t n = other.size();
+    pid.insert(pid.end(), other.pid.begin(), other.pid.end());
+    ppid.insert(ppid.end(), other.ppid.begin(), other.ppid.end());
+    startTime.insert(startTime.end(), other.startTime.begin(), other.startTime.end());
+    cpuPercent.insert(cpuPercent.end(), other.cpuPercent.begin(), other.cpuPercent.end());
+    rssMiB.insert(rssMiB.end(), other.rssMiB.begin(), other.rssMiB.end());
+    uid.insert(uid.end(), other.uid.begin(), other.uid.end());
+
+    // The other arena is copied wholesale; its strings (names and users)
+    // just move by `base`.
+    const uint32_t base = (uint32_t)m_arena.size();
+    m_arena.insert(m_arena.end(), other.m_arena.begin(), other.m_arena.end());
+
+    m_userRemap.clear();
+    for (const auto& u : other.m_users) {
+        const int found = findUser(u.uid);
+        if (found >= 0) {
+            m_userRemap.push_back((uint32_t)found);
+        } else {
+            m_users.push_back(User{u.uid, base + u.off, u.len});
+            m_userRemap.push_back((uint32_t)(m_users.size() - 1));
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        nameOff.push_back(base + other.nameOff[i]);
+        nameLen.push_back(other.nameLen[i]);
+        userIdx.push_back(m_userRemap[other.userIdx[i]]);
+    }
+}
+
+void TaskTable::clear() {
+    tgid.clear();
+    tid.clear();
+    startTime.clear();
+    cpuPercent.clear();
+    state.clear();
+    comm.clear();
+    commLen.clear();
+}
+
+void TaskTable::append(int group, int thread, unsigned long long start, double cpu, char st,
+                       std::string_view name) {
+    tgid.push_back(group);
+    tid.push_back(thread);
+    startTime.push_back(start);
+    cpuPercent.push_back(cpu);
+    state.push_back(st);
+    const size_t len = std::min(name.size(), comm.emplace_back().size());
+    std::memcpy(comm.back().data(), name.data(), len);
+    commLen.push_back((uint8_t)len);
+}
+
+} // namespace FrogKill
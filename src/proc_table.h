@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <sys/types.h>
+
+namespace FrogKill {
+
+// Columnar (struct-of-arrays) process list for one tick.
+//
+// Hot numeric fields live in contiguous arrays; command lines are stored as
+// UTF-8 in a per-table arena and user names are interned once per table.
+// clear() keeps every buffer's capacity, so a table that is recycled
+// between ticks reaches a steady state with no heap allocation.
+class ProcTable {
+public:
+    size_t size() const { return pid.size(); }
+    bool empty() const { return pid.empty(); }
+
+    void clear();
+    void reserve(size_t rows, size_t arenaBytes);
+
+    // Appends one row. `user` is interned by `uid`, so it is only copied the
+    // first time a UID shows up in this table.
+    size_t append(int pid, int ppid, unsigned long long startTime,
+                  double cpuPercent, double rssMiB, uid_t uid,
+                  std::string_view name, std::string_view user);
+
+    // Appends every row of `other` (used to merge per-thread shards).
+    void appendTable(const ProcTable& other);
+    // Appends row `row` of `other`.
+    void appendRow(const ProcTable& other, size_t row);
+
+    // True if `uid` is already interned (callers can skip resolving it).
+    bool hasUser(uid_t uid) const { return findUser(uid) >= 0; }
+
+    std::string_view name(size_t row) const {
+        return {m_arena.data() + nameOff[row], nameLen[row]};
+    }
+    std::string_view user(size_t row) const {
+        const auto& u = m_users[userIdx[row]];
+        return {m_arena.data() + u.off, u.len};
+    }
+
+    // Columns (all of size()).
+    std::vector<int> pid;
+    std::vector<int> ppid;
+    std::vector<unsigned long long> startTime;
+    std::vector<double> cpuPercent;
+    std::vector<double> rssMiB;
+    std::vector<uid_t> uid;
+    std::vector<uint32_t> nameOff;
+    std::vector<uint32_t> nameLen;
+    std::vector<uint32_t> userIdx;
+
+private:
+    struct User {
+        uid_t uid;
+        uint32_t off;
+        uint32_t len;
+    };
+
+    int findUser(uid_t uid) const;
+    uint32_t internUser(uid_t uid, std::string_view name);
+    uint32_t store(std::string_view s);
+
+    std::vector<char> m_arena;
+    std::vector<User> m_users;
+    std::vector<uint32_t> m_userRemap;   // scratch for appendTable()
+};
+
+// Threads of the processes being watched (see ProcSampler::sampleTasks()),
+// for one tick: grouped by process, each group in TID order. Thread names
+// are the kernel's comm (at most 15 bytes), stored inline.
+class TaskTable {
+public:
+    size_t size() const { return tid.size(); }
+    bool empty() const { return tid.empty(); }
+
+    void clear();
+    void append(int tgid, int tid, unsigned long long startTime, double cpuPercent, char state,
+                std::string_view name);
+
+    std::string_view name(size_t row) const { return {comm[row].data(), commLen[row]}; }
+
+    // Columns (all of size()).
+    std::vector<int> tgid;                  // owning process
+    std::vector<int> tid;
+    std::vector<unsigned long long> startTime;
+    std::vector<double> cpuPercent;
+    std::vector<char> state;                // R, S, D, Z, T, t, I ...
+    std::vector<std::array<char, 16>> comm;
+    std::vector<uint8_t> commLen;
+};
+
+} // namespace FrogKill
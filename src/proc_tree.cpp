@@ -0,0 +1,160 @@
+#include "proc_tree.h"
+#include "proc_scanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+namespace {
+
+// Formats "<pid>/task" or "<pid>/task/<tid>/children" (relative to
+// the /proc dirfd) without allocating.
+const char* taskDirPath(char* buf, size_t cap, int pid) {
+    char* p = std::to_chars(buf, buf + cap - 12, pid).ptr;
+    std::memcpy(p, "/task", 6);
+    return buf;
+}
+
+const char* childrenPath(char* buf, size_t cap, int pid, int tid) {
+    char* const end = buf + cap - 16;
+    char* p = std::to_chars(buf, end, pid).ptr;
+    std::memcpy(p, "/task/", 6);
+    p = std::to_chars(p + 6, end, tid).ptr;
+    std::memcpy(p, "/children", 10);
+    return buf;
+}
+
+// Appends the space-separated PIDs of a children file. The file can be
+// large (a shell with thousands of jobs), so it is parsed in chunks.
+// Returns -1 if the file cannot be opened.
+int readChildren(int procFd, const char* relPath, std::vector<int>& out) {
+    const int fd = ::openat(procFd, relPath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    char buf[4096];
+    int cur = 0;
+    bool inNum = false;
+    for (;;) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (n == 0) break;
+        for (ssize_t i = 0; i < n; ++i) {
+            const char c = buf[i];
+            if (c >= '0' && c <= '9') {
+                cur = cur * 10 + (c - '0');
+                inNum = true;
+            } else if (inNum) {
+                out.push_back(cur);
+                cur = 0;
+                inNum = false;
+            }
+        }
+    }
+    if (inNum) out.push_back(cur);
+    ::close(fd);
+    return 0;
+}
+
+} // namespace
+
+ChildrenReader::ChildrenReader() {
+    if (!m_proc.open("/proc")) return;
+    // Probe our own main thread: no children file means no support.
+    char path[96];
+    std::vector<int> none;
+    const int self = (int)::getpid();
+    m_available = readChildren(m_proc.fd(), childrenPath(path, sizeof(path), self, self), none) == 0;
+}
+
+void ChildrenReader::read(int pid, std::vector<int>& out) {
+    // Children hang off the thread that forked them, so every task of the
+    // process has to be read.
+    char taskDir[64] = "/proc/";
+    taskDirPath(taskDir + 6, sizeof(taskDir) - 6, pid);
+    if (!m_tasks.open(taskDir) || !m_tasks.listPids(m_tids)) return;
+    char path[96];
+    for (const int tid : m_tids) {
+        readChildren(m_proc.fd(), childrenPath(path, sizeof(path), pid, tid), out);
+    }
+}
+
+bool collectSubtreeByChildren(int root, std::vector<TreeNode>& out) {
+    out.clear();
+    ChildrenReader children;
+    if (!children.available()) return false;
+    ProcDir proc;
+    if (!proc.open("/proc")) return false;
+    ProcReader reader(proc);
+    StatFields st;
+    if (root <= 0 || !reader.readStat(root, st)) return true;   // gone: empty tree
+
+    // Breadth-first from the root; reversed at the end so children come
+    // before their parents.
+    std::unordered_set<int> seen;
+    out.push_back({root, st.startTime});
+    seen.insert(root);
+
+    std::vector<int> kids;
+    for (size_t i = 0; i < out.size(); ++i) {
+        kids.clear();
+        children.read(out[i].pid, kids);
+        for (const int kid : kids) {
+            if (kid <= 1 || !seen.insert(kid).second) continue;
+            if (!reader.readStat(kid, st)) continue;   // exited meanwhile
+            out.push_back({kid, st.startTime});
+        }
+    }
+    std::reverse(out.begin(), out.end());
+    return true;
+}
+
+bool collectSubtreeByScan(int root, std::vector<TreeNode>& out) {
+    out.clear();
+    ProcDir proc;
+    std::vector<int> pids;
+    if (root <= 0 || !proc.open("/proc") || !proc.listPids(pids)) return false;
+    ProcReader reader(proc);
+
+    std::unordered_map<int, std::vector<TreeNode>> children;
+    children.reserve(pids.size() * 2u + 8u);
+    StatFields st;
+    TreeNode rootNode;
+    for (const int pid : pids) {
+        if (!reader.readStat(pid, st)) continue;
+        if (pid == root) rootNode = {pid, st.startTime};
+        if (pid > 1 && st.ppid >= 0) children[st.ppid].push_back({pid, st.startTime});
+    }
+    if (rootNode.pid == 0) return true;   // gone: empty tree
+
+    // Two-stack postorder: the second stack reversed yields children-first order.
+    std::vector<TreeNode> stack;
+    stack.reserve(256);
+    stack.push_back(rootNode);
+    while (!stack.empty()) {
+        const TreeNode cur = stack.back();
+        stack.pop_back();
+        out.push_back(cur);
+        auto it = children.find(cur.pid);
+        if (it == children.end()) continue;
+        for (const auto& c : it->second) stack.push_back(c);
+    }
+    std::reverse(out.begin(), out.end());
+    return true;
+}
+
+bool collectSubtree(int root, std::vector<TreeNode>& out) {
+    if (!collectSubtreeByChildren(root, out) && !collectSubtreeByScan(root, out)) return false;
+    return !out.empty();
+}
+
+} // namespace FrogKill
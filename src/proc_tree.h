@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+
+#include "proc_scanner.h"
+
+namespace FrogKill {
+
+// Process subtree discovery for tree kills. Qt-free (used by the helper).
+
+struct TreeNode {
+    int pid{0};
+    unsigned long long startTime{0};
+};
+
+// Reads the direct children of a process from /proc/<pid>/task/<tid>/children.
+// Keeps its directory fds and buffers; not thread-safe.
+class ChildrenReader {
+public:
+    ChildrenReader();
+
+    // False if /proc is unreadable or the kernel has no children files.
+    bool available() const { return m_available; }
+    // Appends the children of every thread of `pid` to `out`.
+    void read(int pid, std::vector<int>& out);
+
+private:
+    ProcDir m_proc;
+    ProcDir m_tasks;
+    std::vector<int> m_tids;
+    bool m_available{false};
+};
+
+// Collects `root` and all its descendants into `out`, children before
+// their parents. Each node carries the starttime seen while walking, so
+// callers can bind ProcHandles to exactly those generations.
+//
+// Walks /proc/<pid>/task/<tid>/children down from the root, so the cost is
+// proportional to the subtree. Falls back to collectSubtreeByScan() when
+// the kernel has no children files (CONFIG_PROC_CHILDREN=n). Returns false
+// if the root does not exist.
+bool collectSubtree(int root, std::vector<TreeNode>& out);
+
+// The two strategies, exposed for benchmarking. Both leave `out` empty when
+// the root does not exist and return false only if the strategy itself is
+// unusable.
+//
+// False if the kernel has no children files.
+bool collectSubtreeByChildren(int root, std::vector<TreeNode>& out);
+// Builds the PPID -> children map of the whole system from every
+// /proc/<pid>/stat; cost is proportional to the number of processes.
+bool collectSubtreeByScan(int root, std::vector<TreeNode>& out);
+
+} // namespace FrogKill
@@ -0,0 +1,28 @@
+#include "process_filter_proxy.h"
+#include "proc_filter.h"
+#include "process_model.h"
+
+namespace FrogKill {
+
+ProcessFilterProxy::ProcessFilterProxy(const ProcFilter* filter, QObject* parent)
+    : QSortFilterProxyModel(parent), m_filter(filter) {
+    setSortRole(SortRole);
+}
+
+void ProcessFilterProxy::sort(int column, Qt::SortOrder order) {
+    if (m_sortInSource) sourceModel()->sort(column, order);
+    else QSortFilterProxyModel::sort(column, order);
+}
+
+void ProcessFilterProxy::refilter() {
+    invalidateRowsFilter();
+}
+
+bool ProcessFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    if (!m_filter->active()) return true;
+    bool ok = false;
+    const uint row = sourceModel()->index(sourceRow, 0, sourceParent).data(RowRole).toUInt(&ok);
+    return ok && m_filter->accepts(row);
+}
+
+} // namespace FrogKill
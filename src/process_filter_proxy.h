@@ -0,0 +1,36 @@
+#pragma once
+#include <QSortFilterProxyModel>
+
+namespace FrogKill {
+
+class ProcFilter;
+
+// Proxy for the process views that filters with a ProcFilter instead of a
+// regular expression over formatted columns: accepting a row is one lookup
+// of its snapshot row (RowRole) in the filter's match set.
+//
+// The owner applies the filter to a snapshot before the source model moves
+// to it, and calls refilter() afterwards (or when the query changes).
+//
+// With setSortInSource(), sort() is forwarded to a source model that keeps
+// its rows ordered itself (ProcessModel) and the proxy keeps source order;
+// otherwise the proxy sorts by SortRole.
+class ProcessFilterProxy : public QSortFilterProxyModel {
+    Q_OBJECT
+public:
+    explicit ProcessFilterProxy(const ProcFilter* filter, QObject* parent = nullptr);
+
+    void refilter();
+    void setSortInSource(bool enabled) { m_sortInSource = enabled; }
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    const ProcFilter* m_filter;
+    bool m_sortInSource{false};
+};
+
+} // namespace FrogKill
@@ -1,18 +1,40 @@
 #include "process_model.h"
 #include <QLocale>
 
+#include <algorithm>
+#include <string_view>
+
 namespace FrogKill {
 
+static constexpr unsigned kGone = ~0u;
+
+// Values are displayed with one decimal; changes below that are invisible
+// and not worth a dataChanged.
+static long long displayTenths(double v) { return (long long)(v * 10.0 + 0.5); }
+
+static QString toQString(std::string_view s) {
+    return QString::fromUtf8(s.data(), (qsizetype)s.size());
+}
+
+template <typename T>
+static int compare3(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+// Past this many element moves per row, repairing the previous order costs
+// more than sorting from scratch.
+static constexpr size_t kRepairMovesPerRow = 16;
+
 ProcessModel::ProcessModel(QObject* parent) : QAbstractTableModel(parent) {}
 
 int ProcessModel::rowCount(const QModelIndex& parent) const {
     if (parent.isValid()) return 0;
-    return static_cast<int>(m_rows.size());
+    return static_cast<int>(m_rowToIdx.size());
 }
 
 int ProcessModel::columnCount(const QModelIndex& parent) const {
     if (parent.isValid()) return 0;
-    return 5; // PID, Name, CPU, RSS, User
+    return 6; // PID, Name, CPU, RSS, User, History (painted by SparklineDelegate)
 }
 
 QVariant ProcessModel::headerData(int section, Qt::Orientation orientation, int role) const {
@@ -23,6 +45,7 @@ QVariant ProcessModel::headerData(int section, Qt::Orientation orientation, int
         case 2: return "CPU %";
         case 3: return "RAM (MiB)";
         case 4: return "Usuário";
+        case 5: return "Histórico";
         default: return {};
     }
 }
@@ -31,17 +54,18 @@ QVariant ProcessModel::data(const QModelIndex& index, int role) const {
     if (!index.isValid()) return {};
     const int r = index.row();
     const int c = index.column();
-    if (r < 0 || r >= (int)m_rows.size()) return {};
+    if (r < 0 || r >= rowCount()) return {};
 
-    const auto& p = m_rows[(size_t)r];
+    const auto& t = m_snap->procs;
+    const size_t i = at(r);
 
     if (role == Qt::DisplayRole) {
         switch (c) {
-            case 0: return p.pid;
-            case 1: return p.name;
-            case 2: return QString::number(p.cpuPercent, 'f', 1);
-            case 3: return QString::number(p.rssMiB, 'f', 1);
-            case 4: return p.user;
+            case 0: return t.pid[i];
+            case 1: return toQString(t.name(i));
+            case 2: return QString::number(t.cpuPercent[i], 'f', 1);
+            case 3: return QString::number(t.rssMiB[i], 'f', 1);
+            case 4: return toQString(t.user(i));
         }
     }
 
@@ -49,28 +73,215 @@ QVariant ProcessModel::data(const QModelIndex& index, int role) const {
         if (c == 0 || c == 2 || c == 3) return Qt::AlignRight;
     }
 
+    if (role == SortRole) {
+        switch (c) {
+            case 0: return t.pid[i];
+            case 1: return toQString(t.name(i));
+            case 2: return t.cpuPercent[i];
+            case 3: return t.rssMiB[i];
+            case 4: return toQString(t.user(i));
+        }
+    }
+
+    switch (role) {
+        case PidRole: return t.pid[i];
+        case StartTimeRole: return (qulonglong)t.startTime[i];
+        case NameRole: return toQString(t.name(i));
+        case RowRole: return (uint)i;
+    }
+
     return {};
 }
 
-void ProcessModel::refresh() {
+void ProcessModel::resetTo(const Snapshot* snap) {
     beginResetModel();
-    m_rows = m_sampler.sample();
+    m_snap = snap;
+    const size_t n = snap ? snap->procs.size() : 0;
+    m_rowToIdx.resize(n);
+    for (size_t i = 0; i < n; ++i) m_rowToIdx[i] = (unsigned)i;
+    if (m_sortColumn >= 0) {
+        std::sort(m_rowToIdx.begin(), m_rowToIdx.end(), [this](unsigned a, unsigned b) { return before(a, b); });
+    }
+    m_rowByPid.clear();
+    m_rowByPid.reserve(n * 2 + 64);
+    for (size_t r = 0; r < n; ++r) m_rowByPid.emplace(snap->procs.pid[m_rowToIdx[r]], (int)r);
     endResetModel();
 }
 
+bool ProcessModel::before(unsigned a, unsigned b) const {
+    // CPU and RAM compare at display precision: rows showing the same value
+    // keep their relative order instead of trading places every tick.
+    const ProcTable& t = m_snap->procs;
+    int c = 0;
+    switch (m_sortColumn) {
+        case 1: c = t.name(a).compare(t.name(b)); break;
+        case 2: c = compare3(displayTenths(t.cpuPercent[a]), displayTenths(t.cpuPercent[b])); break;
+        case 3: c = compare3(displayTenths(t.rssMiB[a]), displayTenths(t.rssMiB[b])); break;
+        case 4: c = t.user(a).compare(t.user(b)); break;
+    }
+    if (c == 0) c = compare3(t.pid[a], t.pid[b]);
+    return m_sortOrder == Qt::AscendingOrder ? c < 0 : c > 0;
+}
+
+void ProcessModel::sort(int column, Qt::SortOrder order) {
+    if (column >= columnCount()) column = -1;
+    if (column == 5) return;     // Histórico: painted, not data
+    if (column == m_sortColumn && order == m_sortOrder) return;
+    m_sortColumn = column;
+    m_sortOrder = order;
+    reorder(true);
+}
+
+void ProcessModel::reorder(bool full) {
+    if (!m_snap || m_sortColumn < 0 || m_rowToIdx.size() < 2) return;
+    const auto less = [this](unsigned a, unsigned b) { return before(a, b); };
+    auto& v = m_rowToIdx;
+    if (std::is_sorted(v.begin(), v.end(), less)) return;
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    m_prevOrder = v;
+
+    // Binary insertion over last tick's order: O(n) compares when nothing
+    // moved, plus a memmove per displaced row. Gives up on a new sort key
+    // or when too much moved at once (a load spike).
+    bool repaired = false;
+    if (!full) {
+        const size_t budget = kRepairMovesPerRow * v.size();
+        size_t moves = 0;
+        for (size_t i = 1; i < v.size() && moves <= budget; ++i) {
+            if (!less(v[i], v[i - 1])) continue;
+            const unsigned x = v[i];
+            const auto pos = std::upper_bound(v.begin(), v.begin() + (ptrdiff_t)i, x, less);
+            std::move_backward(pos, v.begin() + (ptrdiff_t)i, v.begin() + (ptrdiff_t)i + 1);
+            *pos = x;
+            moves += (size_t)(v.begin() + (ptrdiff_t)i - pos);
+        }
+        repaired = moves <= budget;
+    }
+    if (!repaired) std::sort(v.begin(), v.end(), less);
+
+    const ProcTable& t = m_snap->procs;
+    m_newRow.resize(t.size());
+    for (size_t r = 0; r < v.size(); ++r) {
+        m_newRow[v[r]] = (int)r;
+        if (v[r] != m_prevOrder[r]) m_rowByPid[t.pid[v[r]]] = (int)r;
+    }
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex& i : from) to.push_back(index(m_newRow[m_prevOrder[(size_t)i.row()]], i.column()));
+    changePersistentIndexList(from, to);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void ProcessModel::setSnapshot(const Snapshot* snap) {
+    if (!m_snap || !snap) {
+        resetTo(snap);
+        return;
+    }
+
+    const ProcTable& oldT = m_snap->procs;
+    const ProcTable& newT = snap->procs;
+
+    // Match the new snapshot against current rows by PID; a PID whose start
+    // time differs is a different process (PID reuse): old row goes, new
+    // row comes.
+    m_nextIdx.assign(m_rowToIdx.size(), kGone);
+    m_inserted.clear();
+    for (unsigned i = 0; i < (unsigned)newT.size(); ++i) {
+        auto it = m_rowByPid.find(newT.pid[i]);
+        if (it != m_rowByPid.end()) {
+            const int r = it->second;
+            if (oldT.startTime[m_rowToIdx[(size_t)r]] == newT.startTime[i]) {
+                m_nextIdx[(size_t)r] = i;
+                continue;
+            }
+        }
+        m_inserted.push_back(i);
+    }
+
+    // 1) Removals, highest rows first so earlier row numbers stay valid.
+    //    The model still reads the old snapshot during this phase.
+    size_t firstShifted = m_rowToIdx.size();
+    for (size_t r = m_rowToIdx.size(); r > 0;) {
+        if (m_nextIdx[r - 1] != kGone) { --r; continue; }
+        const size_t hi = r - 1;
+        while (r > 0 && m_nextIdx[r - 1] == kGone) --r;
+        const size_t lo = r;
+
+        beginRemoveRows(QModelIndex(), (int)lo, (int)hi);
+        for (size_t k = lo; k <= hi; ++k) m_rowByPid.erase(oldT.pid[m_rowToIdx[k]]);
+        m_rowToIdx.erase(m_rowToIdx.begin() + (ptrdiff_t)lo, m_rowToIdx.begin() + (ptrdiff_t)hi + 1);
+        m_nextIdx.erase(m_nextIdx.begin() + (ptrdiff_t)lo, m_nextIdx.begin() + (ptrdiff_t)hi + 1);
+        endRemoveRows();
+        firstShifted = lo;
+    }
+
+    // 2) Switch surviving rows to the new snapshot, remembering which
+    //    columns actually changed. Signals go out once everything points at
+    //    the new snapshot, so handlers never see a half-switched model.
+    auto& changes = m_changes;
+    changes.clear();
+    for (size_t r = 0; r < m_rowToIdx.size(); ++r) {
+        const size_t a = m_rowToIdx[r];
+        const size_t b = m_nextIdx[r];
+        m_rowToIdx[r] = m_nextIdx[r];
+        if (r >= firstShifted) m_rowByPid[newT.pid[b]] = (int)r;
+
+        int c0 = 5, c1 = -1;
+        auto mark = [&](int c) { c0 = std::min(c0, c); c1 = std::max(c1, c); };
+        if (oldT.name(a) != newT.name(b)) mark(1);
+        if (displayTenths(oldT.cpuPercent[a]) != displayTenths(newT.cpuPercent[b])) mark(2);
+        if (displayTenths(oldT.rssMiB[a]) != displayTenths(newT.rssMiB[b])) mark(3);
+        if (oldT.user(a) != newT.user(b)) mark(4);
+        if (c1 >= 0) changes.push_back(Change{(int)r, c0, c1});
+    }
+    m_snap = snap;
+
+    for (size_t i = 0; i < changes.size();) {
+        // Coalesce consecutive rows with the same column range.
+        size_t j = i + 1;
+        while (j < changes.size() && changes[j].row == changes[j - 1].row + 1
+               && changes[j].c0 == changes[i].c0 && changes[j].c1 == changes[i].c1) {
+            ++j;
+        }
+        emit dataChanged(index(changes[i].row, changes[i].c0), index(changes[j - 1].row, changes[i].c1),
+                         {Qt::DisplayRole});
+        i = j;
+    }
+
+    // 3) New processes are appended, then 4) moved into place along with
+    //    the rows whose sort key changed.
+    if (!m_inserted.empty()) {
+        const int first = (int)m_rowToIdx.size();
+        beginInsertRows(QModelIndex(), first, first + (int)m_inserted.size() - 1);
+        for (const unsigned i : m_inserted) {
+            m_rowByPid[newT.pid[i]] = (int)m_rowToIdx.size();
+            m_rowToIdx.push_back(i);
+        }
+        endInsertRows();
+    }
+    reorder(false);
+}
+
 int ProcessModel::pidAtRow(int row) const {
-    if (row < 0 || row >= (int)m_rows.size()) return -1;
-    return m_rows[(size_t)row].pid;
+    if (row < 0 || row >= rowCount()) return -1;
+    return m_snap->procs.pid[at(row)];
 }
 
 int ProcessModel::ppidAtRow(int row) const {
-    if (row < 0 || row >= (int)m_rows.size()) return -1;
-    return m_rows[(size_t)row].ppid;
+    if (row < 0 || row >= rowCount()) return -1;
+    return m_snap->procs.ppid[at(row)];
+}
+
+unsigned long long ProcessModel::startTimeAtRow(int row) const {
+    if (row < 0 || row >= rowCount()) return 0;
+    return m_snap->procs.startTime[at(row)];
 }
 
 QString ProcessModel::nameAtRow(int row) const {
-    if (row < 0 || row >= (int)m_rows.size()) return {};
-    return m_rows[(size_t)row].name;
+    if (row < 0 || row >= rowCount()) return {};
+    return toQString(m_snap->procs.name(at(row)));
 }
 
 } // namespace FrogKill
@@ -1,10 +1,21 @@
 #pragma once
 #include <QAbstractTableModel>
+#include <unordered_map>
 #include <vector>
-#include "procfs.h"
+#include "snapshot.h"
 
 namespace FrogKill {
 
+// Roles shared by the table and tree models; the kill actions read the
+// target through them, whatever view and proxy sit in between.
+enum ProcessRole {
+    PidRole = Qt::UserRole + 1,
+    StartTimeRole,
+    NameRole,
+    RowRole,        // row in the snapshot's ProcTable (for ProcFilter)
+    SortRole,       // raw value of the column (numbers as numbers)
+};
+
 class ProcessModel : public QAbstractTableModel {
     Q_OBJECT
 public:
@@ -16,15 +27,52 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
-    void refresh();
+    // Points the model at a new snapshot. The snapshot must stay alive (and
+    // unmodified) until the next call. Rows are matched by (pid, startTime)
+    // and only removed/inserted/changed rows are signalled (plus a layout
+    // change if the sort order moved).
+    void setSnapshot(const Snapshot* snap);
+
+    // Current snapshot (columns are read directly, e.g. for tree walks).
+    const Snapshot* snapshot() const { return m_snap; }
+
+    // The model keeps its rows in this order itself: each tick repairs the
+    // previous order instead of sorting from scratch. Column -1 keeps
+    // arrival order. The history column has no sort key and is ignored.
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    int sortColumn() const { return m_sortColumn; }
+    Qt::SortOrder sortOrder() const { return m_sortOrder; }
 
     int pidAtRow(int row) const;
     int ppidAtRow(int row) const;
+    unsigned long long startTimeAtRow(int row) const;
     QString nameAtRow(int row) const;
 
 private:
-    std::vector<ProcInfo> m_rows;
-    ProcSampler m_sampler;
+    // Index of `row` in m_snap->procs.
+    size_t at(int row) const { return m_rowToIdx[(size_t)row]; }
+    void resetTo(const Snapshot* snap);
+    // Strict order of two snapshot rows under the current sort.
+    bool before(unsigned a, unsigned b) const;
+    // Restores the sort order of m_rowToIdx; `full` skips the adaptive pass.
+    void reorder(bool full);
+
+    int m_sortColumn{-1};
+    Qt::SortOrder m_sortOrder{Qt::AscendingOrder};
+
+    const Snapshot* m_snap{nullptr};
+    // Rows keep their order across ticks unless their sort key moves them;
+    // each maps into m_snap->procs.
+    std::vector<unsigned> m_rowToIdx;
+    std::unordered_map<int, int> m_rowByPid;
+
+    // Per-tick scratch, kept to avoid reallocating.
+    struct Change { int row; int c0; int c1; };
+    std::vector<unsigned> m_nextIdx;      // per row: index in the new snapshot
+    std::vector<unsigned> m_inserted;     // new snapshot indices without a row
+    std::vector<Change> m_changes;
+    std::vector<unsigned> m_prevOrder;
+    std::vector<int> m_newRow;            // per snapshot index
 };
 
 } // namespace FrogKill
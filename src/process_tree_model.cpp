@@ -0,0 +1,253 @@
+#include "process_tree_model.h"
+#include "process_model.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace FrogKill {
+
+static constexpr int kColumns = 5;   // Name, PID, CPU, RSS, User
+
+// Values are displayed with one decimal; changes below that are invisible
+// and not worth a dataChanged.
+static long long displayTenths(double v) { return (long long)(v * 10.0 + 0.5); }
+
+static QString toQString(std::string_view s) {
+    return QString::fromUtf8(s.data(), (qsizetype)s.size());
+}
+
+// PID of the parent of row `r` (0 for a root).
+static int parentPidOf(const Snapshot* s, uint32_t r) {
+    const uint32_t p = s->tree.parent(r);
+    return p == ProcIndex::kNone ? 0 : s->procs.pid[p];
+}
+
+ProcessTreeModel::ProcessTreeModel(QObject* parent) : QAbstractItemModel(parent) {}
+
+const std::vector<int>& ProcessTreeModel::kidsOf(int parentPid) const {
+    static const std::vector<int> kNoKids;
+    if (parentPid == 0) return m_roots;
+    const auto it = m_nodes.find(parentPid);
+    return it == m_nodes.end() ? kNoKids : it->second.kids;
+}
+
+std::vector<int>& ProcessTreeModel::kidsOf(int parentPid) {
+    return parentPid == 0 ? m_roots : m_nodes.at(parentPid).kids;
+}
+
+int ProcessTreeModel::rowIn(int parentPid, int pid) const {
+    const auto& kids = kidsOf(parentPid);
+    return (int)(std::lower_bound(kids.begin(), kids.end(), pid) - kids.begin());
+}
+
+QModelIndex ProcessTreeModel::indexOf(int pid) const {
+    const auto it = m_nodes.find(pid);
+    if (it == m_nodes.end()) return {};
+    return createIndex(rowIn(it->second.parentPid, pid), 0, (quintptr)pid);
+}
+
+QModelIndex ProcessTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (row < 0 || column < 0 || column >= kColumns) return {};
+    if (parent.isValid() && parent.column() != 0) return {};
+    const auto& kids = kidsOf(parent.isValid() ? (int)parent.internalId() : 0);
+    if (row >= (int)kids.size()) return {};
+    return createIndex(row, column, (quintptr)kids[(size_t)row]);
+}
+
+QModelIndex ProcessTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) return {};
+    const auto it = m_nodes.find((int)child.internalId());
+    if (it == m_nodes.end() || it->second.parentPid == 0) return {};
+    return indexOf(it->second.parentPid);
+}
+
+int ProcessTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid() && parent.column() != 0) return 0;
+    return (int)kidsOf(parent.isValid() ? (int)parent.internalId() : 0).size();
+}
+
+int ProcessTreeModel::columnCount(const QModelIndex&) const {
+    return kColumns;
+}
+
+QVariant ProcessTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+    switch (section) {
+        case 0: return "Processo";
+        case 1: return "PID";
+        case 2: return "CPU %";
+        case 3: return "RAM (MiB)";
+        case 4: return "Usuário";
+        default: return {};
+    }
+}
+
+QVariant ProcessTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || !m_snap) return {};
+    const auto it = m_nodes.find((int)index.internalId());
+    if (it == m_nodes.end()) return {};
+
+    const auto& t = m_snap->procs;
+    const auto& tree = m_snap->tree;
+    const uint32_t i = it->second.row;
+    const int c = index.column();
+
+    if (role == Qt::DisplayRole) {
+        switch (c) {
+            case 0: return toQString(t.name(i));
+            case 1: return t.pid[i];
+            // Subtree totals (equal to the process's own values for a leaf).
+            case 2: return QString::number(tree.subtreeCpu(i), 'f', 1);
+            case 3: return QString::number(tree.subtreeRss(i), 'f', 1);
+            case 4: return toQString(t.user(i));
+        }
+    }
+
+    if (role == Qt::ToolTipRole && (c == 2 || c == 3) && tree.subtreeSize(i) > 1) {
+        const double own = c == 2 ? t.cpuPercent[i] : t.rssMiB[i];
+        const double total = c == 2 ? tree.subtreeCpu(i) : tree.subtreeRss(i);
+        return QString("Processo: %1 — com %2 descendentes: %3")
+            .arg(own, 0, 'f', 1).arg(tree.subtreeSize(i) - 1).arg(total, 0, 'f', 1);
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        if (c == 1 || c == 2 || c == 3) return Qt::AlignRight;
+    }
+
+    if (role == SortRole) {
+        switch (c) {
+            case 0: return toQString(t.name(i));
+            case 1: return t.pid[i];
+            case 2: return tree.subtreeCpu(i);
+            case 3: return tree.subtreeRss(i);
+            case 4: return toQString(t.user(i));
+        }
+    }
+
+    switch (role) {
+        case PidRole: return t.pid[i];
+        case StartTimeRole: return (qulonglong)t.startTime[i];
+        case NameRole: return toQString(t.name(i));
+        case RowRole: return (uint)i;
+    }
+
+    return {};
+}
+
+void ProcessTreeModel::addSubtree(const Snapshot* snap, uint32_t r, int parentPid) {
+    const ProcTable& t = snap->procs;
+    for (const uint32_t x : snap->tree.subtree(r)) {
+        Node& n = m_nodes[t.pid[x]];
+        n.parentPid = x == r ? parentPid : parentPidOf(snap, x);
+        n.startTime = t.startTime[x];
+        n.row = x;
+        n.kids.clear();
+        for (const uint32_t c : snap->tree.children(x)) n.kids.push_back(t.pid[c]);
+    }
+}
+
+void ProcessTreeModel::eraseSubtree(int pid) {
+    std::vector<int> stack{pid};
+    while (!stack.empty()) {
+        const auto it = m_nodes.find(stack.back());
+        stack.pop_back();
+        if (it == m_nodes.end()) continue;
+        stack.insert(stack.end(), it->second.kids.begin(), it->second.kids.end());
+        m_nodes.erase(it);
+    }
+}
+
+void ProcessTreeModel::resetTo(const Snapshot* snap) {
+    beginResetModel();
+    m_snap = snap;
+    m_nodes.clear();
+    m_roots.clear();
+    if (snap) {
+        m_nodes.reserve(snap->procs.size() * 2 + 64);
+        for (const uint32_t r : snap->tree.roots()) {
+            m_roots.push_back(snap->procs.pid[r]);
+            addSubtree(snap, r, 0);
+        }
+    }
+    endResetModel();
+}
+
+void ProcessTreeModel::setSnapshot(const Snapshot* snap) {
+    if (!m_snap || !snap) {
+        resetTo(snap);
+        return;
+    }
+
+    const ProcTable& oldT = m_snap->procs;
+    const ProcTable& newT = snap->procs;
+    const ProcIndex& oldX = m_snap->tree;
+    const ProcIndex& newX = snap->tree;
+
+    // 1) Removals: processes that exited, were reparented or whose PID was
+    //    reused go with their whole subtree (survivors below them come back
+    //    in step 3). The model still reads the old snapshot here.
+    m_doomed.clear();
+    for (const auto& [pid, node] : m_nodes) {
+        const uint32_t r = newX.rowOf(pid);
+        if (r == ProcIndex::kNone || newT.startTime[r] != node.startTime || parentPidOf(snap, r) != node.parentPid) {
+            m_doomed.push_back(pid);
+        }
+    }
+    for (const int pid : m_doomed) {
+        const auto it = m_nodes.find(pid);
+        if (it == m_nodes.end()) continue;   // already gone with an ancestor
+        const int parentPid = it->second.parentPid;
+        const int row = rowIn(parentPid, pid);
+        beginRemoveRows(parentPid ? indexOf(parentPid) : QModelIndex(), row, row);
+        auto& kids = kidsOf(parentPid);
+        kids.erase(kids.begin() + row);
+        eraseSubtree(pid);
+        endRemoveRows();
+    }
+
+    // 2) Switch the survivors to the new snapshot, remembering which ones
+    //    display something else now.
+    m_changed.assign(newT.size(), 0);
+    for (auto& [pid, node] : m_nodes) {
+        const uint32_t a = node.row;
+        const uint32_t b = newX.rowOf(pid);
+        node.row = b;
+        m_changed[b] = oldT.name(a) != newT.name(b)
+            || displayTenths(oldX.subtreeCpu(a)) != displayTenths(newX.subtreeCpu(b))
+            || displayTenths(oldX.subtreeRss(a)) != displayTenths(newX.subtreeRss(b))
+            || oldT.user(a) != newT.user(b);
+    }
+    m_snap = snap;
+
+    auto emitChanged = [&](const std::vector<int>& kids) {
+        for (size_t k = 0; k < kids.size();) {
+            if (!m_changed[m_nodes.at(kids[k]).row]) {
+                ++k;
+                continue;
+            }
+            size_t j = k + 1;
+            while (j < kids.size() && m_changed[m_nodes.at(kids[j]).row]) ++j;
+            emit dataChanged(createIndex((int)k, 0, (quintptr)kids[k]),
+                             createIndex((int)j - 1, kColumns - 1, (quintptr)kids[j - 1]),
+                             {Qt::DisplayRole, Qt::ToolTipRole});
+            k = j;
+        }
+    };
+    emitChanged(m_roots);
+    for (const auto& [pid, node] : m_nodes) emitChanged(node.kids);
+
+    // 3) New processes, parents first; each goes in with its whole subtree.
+    for (const uint32_t r : newX.preorder()) {
+        const int pid = newT.pid[r];
+        if (m_nodes.count(pid)) continue;
+        const int parentPid = parentPidOf(snap, r);
+        auto& kids = kidsOf(parentPid);
+        const int row = (int)(std::lower_bound(kids.begin(), kids.end(), pid) - kids.begin());
+        beginInsertRows(parentPid ? indexOf(parentPid) : QModelIndex(), row, row);
+        kids.insert(kids.begin() + row, pid);
+        addSubtree(snap, r, parentPid);
+        endInsertRows();
+    }
+}
+
+} // namespace FrogKill
@@ -0,0 +1,61 @@
+#pragma once
+#include <QAbstractItemModel>
+#include <unordered_map>
+#include <vector>
+#include "snapshot.h"
+
+namespace FrogKill {
+
+// Process hierarchy view of a snapshot, on top of its ProcIndex. CPU and
+// RAM of a process with children are the totals of its subtree (its own
+// values are in the tooltip).
+//
+// Nodes are keyed by PID (the index's internalId), so expansion and
+// selection survive ticks: a process that exits, is reparented or whose
+// PID was reused is removed with its subtree, new ones are inserted under
+// their parent, and the rest only get dataChanged.
+class ProcessTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+public:
+    explicit ProcessTreeModel(QObject* parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    // Same contract as ProcessModel::setSnapshot().
+    void setSnapshot(const Snapshot* snap);
+
+private:
+    struct Node {
+        int parentPid{0};               // 0 = top level
+        unsigned long long startTime{0};
+        uint32_t row{0};                // row in m_snap->procs
+        std::vector<int> kids;          // PIDs, ascending
+    };
+
+    const std::vector<int>& kidsOf(int parentPid) const;
+    std::vector<int>& kidsOf(int parentPid);
+    // Position of `pid` among its siblings.
+    int rowIn(int parentPid, int pid) const;
+    QModelIndex indexOf(int pid) const;
+
+    void resetTo(const Snapshot* snap);
+    // Adds the node of snapshot row `r` and its whole subtree.
+    void addSubtree(const Snapshot* snap, uint32_t r, int parentPid);
+    void eraseSubtree(int pid);
+
+    const Snapshot* m_snap{nullptr};
+    std::unordered_map<int, Node> m_nodes;   // by PID
+    std::vector<int> m_roots;                // PIDs, ascending
+
+    // Per-tick scratch, kept to avoid reallocating.
+    std::vector<int> m_doomed;
+    std::vector<char> m_changed;             // per row of the new snapshot
+};
+
+} // namespace FrogKill
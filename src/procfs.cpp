@@ -1,165 +1,323 @@
 #include "procfs.h"
 #include "util.h"
+#include "worker_pool.h"
 
-#include <QFile>
-#include <QByteArray>
-#include <QStringList>
-
-#include <filesystem>
-#include <fstream>
-#include <sstream>
-#include <vector>
 #include <algorithm>
-#include <cctype>
+#include <charconv>
+#include <iterator>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <unistd.h>
 
-namespace fs = std::filesystem;
-
 namespace FrogKill {
 
-static bool isDigits(const std::string& s) {
-    return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char ch){ return std::isdigit(ch); });
+// Shards per worker: small enough to balance uneven /proc entries
+// (fat cmdlines, slow kernel threads), large enough to keep dispatch cheap.
+static constexpr int kShardsPerWorker = 4;
+// Below this many PIDs a parallel scan costs more than it saves.
+static constexpr size_t kMinParallelPids = 512;
+
+static constexpr unsigned kPfKthread = 0x00200000;
+// Metadata of a live process is re-read after 1, 2, 4 ... ticks, then every
+// kMaxRefreshStep ticks (catches setuid() and argv rewriting). With proc
+// connector events only argv rewriting goes unnoticed, so back off further.
+static constexpr unsigned kMaxRefreshStep = 32;
+static constexpr unsigned kMaxRefreshStepEvents = 256;
+// The state table is swept completely about every kSweepTicks ticks.
+static constexpr size_t kSweepTicks = 8;
+static constexpr size_t kMinSweep = 256;
+
+ProcSampler::ProcSampler(const char* procRoot) : m_liveProc(std::strcmp(procRoot, "/proc") == 0) {
+    m_dir.open(procRoot);
 }
 
-static bool readFileToString(const std::string& path, std::string& out) {
-    std::ifstream f(path, std::ios::in | std::ios::binary);
-    if (!f) return false;
-    std::ostringstream ss;
-    ss << f.rdbuf();
-    out = ss.str();
-    return true;
+ProcSampler::~ProcSampler() = default;
+
+void ProcSampler::setThreads(int threads) {
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    if (threads == m_threads) return;
+    m_threads = threads;
+    m_pool.reset();
+    m_workerReaders.clear();
+    m_shards.clear();
+    if (threads > 1) {
+        m_pool = std::make_unique<WorkerPool>(threads);
+        for (int i = 0; i < threads; ++i) {
+            m_workerReaders.push_back(std::make_unique<ProcReader>(m_dir));
+        }
+        m_shards.resize((size_t)threads * kShardsPerWorker);
+    }
 }
 
-long long ProcSampler::readTotalJiffies() const {
-    std::ifstream f("/proc/stat");
-    if (!f) return 0;
-    std::string cpu;
-    f >> cpu;
-    if (cpu != "cpu") return 0;
-    long long v = 0, sum = 0;
-    while (f >> v) {
-        sum += v;
+bool ProcSampler::setEventDriven(bool enabled) {
+    if (!enabled) {
+        m_events.reset();
+        return false;
     }
-    return sum;
+    if (m_events) return true;
+    if (!m_liveProc) return false;
+    auto events = std::make_unique<ProcEvents>();
+    if (!events->open()) return false;
+    m_events = std::move(events);
+    m_resync = true;
+    return true;
 }
 
-std::vector<ProcInfo> ProcSampler::sample() {
-    const int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
-    const long long totalJ = readTotalJiffies();
-    const long long prevTotal = m_prevTotalJiffies;
-    const long long deltaTotal = (prevTotal > 0 && totalJ > prevTotal) ? (totalJ - prevTotal) : 0;
-    m_prevTotalJiffies = totalJ;
+bool ProcSampler::collectPids() {
+    m_forced.clear();
+    if (!m_events) return m_dir.listPids(m_pids);
 
-    std::vector<ProcInfo> out;
-    out.reserve(1024);
+    m_batch.added.clear();
+    m_batch.changed.clear();
+    m_batch.overflow = false;
+    m_events->drain(m_batch);
+    if (m_batch.overflow) m_resync = true;
 
-    for (const auto& entry : fs::directory_iterator("/proc")) {
-        if (!entry.is_directory()) continue;
-        const std::string pidStr = entry.path().filename().string();
-        if (!isDigits(pidStr)) continue;
+    if (m_resync) {
+        // Events already queued are applied on the next tick; duplicates
+        // of walked PIDs are harmless.
+        if (!m_dir.listPids(m_pids)) return false;
+        if (!std::is_sorted(m_pids.begin(), m_pids.end())) std::sort(m_pids.begin(), m_pids.end());
+        m_resync = false;
+        ++m_resyncs;
+        return true;
+    }
 
-        const int pid = std::stoi(pidStr);
+    // m_pids holds last tick's live set (sorted); add the forked ones.
+    // Exited processes drop out when their stat read fails.
+    auto& added = m_batch.added;
+    if (!added.empty()) {
+        std::sort(added.begin(), added.end());
+        // A TGID can fork twice in one tick (exit plus PID reuse).
+        added.erase(std::unique(added.begin(), added.end()), added.end());
+        m_pidScratch.clear();
+        std::set_union(m_pids.begin(), m_pids.end(), added.begin(), added.end(),
+                       std::back_inserter(m_pidScratch));
+        m_pids.swap(m_pidScratch);
+    }
+    m_forced.assign(m_batch.changed.begin(), m_batch.changed.end());
+    std::sort(m_forced.begin(), m_forced.end());
+    m_forced.erase(std::unique(m_forced.begin(), m_forced.end()), m_forced.end());
+    return true;
+}
 
-        // Parse /proc/[pid]/stat for comm, ppid, utime, stime
-        std::string statLine;
-        if (!readFileToString("/proc/" + pidStr + "/stat", statLine)) continue;
+long long ProcSampler::readTotalJiffies() {
+    // First line of /proc/stat: "cpu  user nice system idle ..."
+    char buf[512];
+    size_t len = 0;
+    if (!m_reader.readRaw("stat", buf, sizeof(buf), len) || len < 4) return 0;
+    if (buf[0] != 'c' || buf[1] != 'p' || buf[2] != 'u' || buf[3] != ' ') return 0;
+    const char* p = buf + 4;
+    const char* end = buf + len;
+    long long sum = 0;
+    while (p < end && *p != '\n') {
+        if (*p == ' ') { ++p; continue; }
+        long long v = 0;
+        const auto r = std::from_chars(p, end, v);
+        if (r.ec != std::errc{}) break;
+        sum += v;
+        p = r.ptr;
+    }
+    return sum;
+}
 
-        const auto lpar = statLine.find('(');
-        const auto rpar = statLine.rfind(')');
-        if (lpar == std::string::npos || rpar == std::string::npos || rpar <= lpar) continue;
+void ProcSampler::scanRange(ProcReader& reader, const int* begin, const int* end,
+                            const TickContext& ctx, Shard& out) const {
+    StatFields st;
+    for (const int* it = begin; it != end; ++it) {
+        const int pid = *it;
+        // stat gives comm, ppid, flags, utime, stime, starttime; a vanished
+        // PID just fails here.
+        if (!reader.readStat(pid, st)) continue;
 
-        const std::string comm = statLine.substr(lpar + 1, rpar - lpar - 1);
-        const std::string rest = statLine.substr(rpar + 2); // after ") "
-        std::istringstream rs(rest);
+        RowMeta m;
+        m.procJiffies = st.utime + st.stime;
+        m.commLen = (unsigned char)std::min(st.commLen, (int)sizeof(m.comm));
+        std::memcpy(m.comm, st.comm, m.commLen);
+        m.slot = m_state.findSlot(pid, st.startTime);
+        const PidState* prev = (m.slot != PidStateTable::kNoSlot) ? &m_state.at(m.slot) : nullptr;
 
-        std::vector<std::string> tok;
-        tok.reserve(64);
-        std::string t;
-        while (rs >> t) tok.push_back(t);
-        if (tok.size() < 13) continue;
+        // RSS changes all the time; statm is small and always read.
+        long long rssPages = 0;
+        reader.readRssPages(pid, rssPages);
 
-        const int ppid = std::stoi(tok[1]);     // field4
-        const long long utime = std::stoll(tok[11]); // field14
-        const long long stime = std::stoll(tok[12]); // field15
-        const long long procJ = utime + stime;
+        // cmdline and uid are only re-read for new generations, after an
+        // exec (comm changed or an event said so) or when the entry's
+        // backoff timer is due.
+        m.reread = !prev
+            || (!prev->kernelThread && ctx.tick >= prev->nextRefresh)
+            || prev->commLen != m.commLen
+            || std::memcmp(prev->comm, m.comm, m.commLen) != 0
+            || (!m_forced.empty() && std::binary_search(m_forced.begin(), m_forced.end(), pid));
 
-        // Read /proc/[pid]/status for VmRSS and Uid
-        std::string status;
-        long long rssKb = 0;
         uid_t uid = 0;
-        if (readFileToString("/proc/" + pidStr + "/status", status)) {
-            std::istringstream ss(status);
-            std::string line;
-            while (std::getline(ss, line)) {
-                if (line.rfind("VmRSS:", 0) == 0) {
-                    // VmRSS:   12345 kB
-                    std::istringstream ls(line);
-                    std::string key, unit;
-                    ls >> key >> rssKb >> unit;
-                } else if (line.rfind("Uid:", 0) == 0) {
-                    std::istringstream ls(line);
-                    std::string key;
-                    long long ruid = 0;
-                    ls >> key >> ruid;
-                    uid = (uid_t)ruid;
-                }
-            }
+        std::string_view name;
+        QByteArray user;
+        if (m.reread) {
+            reader.readUid(pid, uid);
+            const char* cmd = nullptr;
+            const size_t cmdLen = reader.readCmdline(pid, cmd);
+            m.hasCmdline = cmdLen > 0;
+            m.kernelThread = (st.flags & kPfKthread) != 0;
+            name = m.hasCmdline ? std::string_view(cmd, cmdLen)
+                                : std::string_view(st.comm, (size_t)st.commLen);
+            // User names are interned per table; resolve only on first sight
+            // (the cache follows /etc/passwd changes).
+            if (!out.rows.hasUser(uid)) user = Util::usernameUtf8FromUid(uid);
+        } else {
+            uid = prev->uid;
+            name = !prev->cmdline.empty() ? std::string_view(prev->cmdline)
+                                          : std::string_view(st.comm, (size_t)st.commLen);
+            if (!out.rows.hasUser(uid)) user = Util::usernameUtf8FromUid(uid);
         }
 
-        // Read cmdline (optional)
-        std::string cmdline;
-        QString display = QString::fromStdString(comm);
-        if (readFileToString("/proc/" + pidStr + "/cmdline", cmdline) && !cmdline.empty()) {
-            // cmdline is NUL-separated
-            for (auto& ch : cmdline) if (ch == '\0') ch = ' ';
-            const auto trimmed = Util::trimmed(QString::fromStdString(cmdline));
-            if (!trimmed.isEmpty()) display = trimmed;
-        }
+        const double cpu = prev ? cpuPercent(m.procJiffies - prev->procJiffies, ctx) : 0.0;
 
-        ProcInfo info;
-        info.pid = pid;
-        info.ppid = ppid;
-        info.name = display;
-        info.user = Util::usernameFromUid(uid);
-        info.rssMiB = rssKb / 1024.0;
-
-        // CPU %
-        double cpu = 0.0;
-        auto it = m_prevByPid.find(pid);
-        if (deltaTotal > 0 && it != m_prevByPid.end()) {
-            const long long deltaProc = procJ - it->second.procJiffies;
-            if (deltaProc > 0) {
-                cpu = 100.0 * (double)deltaProc / (double)deltaTotal * (double)cores;
-                if (cpu < 0) cpu = 0;
-                const double maxCpu = 100.0 * (double)cores;
-                if (cpu > maxCpu) cpu = maxCpu;
-            }
+        out.rows.append(pid, st.ppid, st.startTime, cpu,
+                        (double)(rssPages * ctx.pageKb) / 1024.0, uid,
+                        name, std::string_view(user.constData(), (size_t)user.size()));
+        out.meta.push_back(m);
+    }
+}
+
+double ProcSampler::cpuPercent(long long deltaJiffies, const TickContext& ctx) {
+    if (ctx.deltaTotal <= 0 || deltaJiffies <= 0) return 0.0;
+    const double cpu = 100.0 * (double)deltaJiffies / (double)ctx.deltaTotal * (double)ctx.cores;
+    return std::min(cpu, 100.0 * (double)ctx.cores);
+}
+
+void ProcSampler::updateState(unsigned tick) {
+    const ProcTable& rows = m_serial.rows;
+    const auto& meta = m_serial.meta;
+    size_t reads = 0;
+    const unsigned maxStep = m_events ? kMaxRefreshStepEvents : kMaxRefreshStep;
+
+    auto applyMetadata = [&](PidState& e, size_t i) {
+        const RowMeta& m = meta[i];
+        ++reads;
+        e.uid = rows.uid[i];
+        const std::string_view user = rows.user(i);
+        if (e.user.size() != (qsizetype)user.size()
+            || std::memcmp(e.user.constData(), user.data(), user.size()) != 0) {
+            e.user = QByteArray(user.data(), (qsizetype)user.size());
         }
-        info.cpuPercent = cpu;
+        if (m.hasCmdline) e.cmdline.assign(rows.name(i));
+        else e.cmdline.clear();
+        // A new image (exec) restarts the backoff.
+        if (e.commLen != m.commLen || std::memcmp(e.comm, m.comm, m.commLen) != 0) e.refreshStep = 1;
+        std::memcpy(e.comm, m.comm, m.commLen);
+        e.commLen = m.commLen;
+        e.kernelThread = m.kernelThread;
+        e.nextRefresh = tick + e.refreshStep;
+        if (e.refreshStep < maxStep) e.refreshStep *= 2;
+    };
 
-        m_prevByPid[pid] = Prev{procJ};
-        out.push_back(std::move(info));
+    // Known generations first: their slot indices are only stable until the
+    // first insert.
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const RowMeta& m = meta[i];
+        if (m.slot == PidStateTable::kNoSlot) continue;
+        PidState& e = m_state.at(m.slot);
+        e.procJiffies = m.procJiffies;
+        e.lastSeen = tick;
+        if (m.reread) applyMetadata(e, i);
+    }
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const RowMeta& m = meta[i];
+        if (m.slot != PidStateTable::kNoSlot) continue;
+        PidState& e = m_state.insert(rows.pid[i], rows.startTime[i]);
+        e.procJiffies = m.procJiffies;
+        e.lastSeen = tick;
+        applyMetadata(e, i);
     }
+    m_metadataReads = reads;
+
+    // Incremental eviction of dead generations: a full pass over the table
+    // every few ticks, never a rebuild.
+    m_state.sweep(tick, std::max<size_t>(kMinSweep, m_state.capacity() / kSweepTicks));
+}
+
+void ProcSampler::sample(ProcTable& out) {
+    TickContext ctx;
+    ctx.cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    ctx.pageKb = sysconf(_SC_PAGESIZE) / 1024;
+    const long long totalJ = readTotalJiffies();
+    const long long prevTotal = m_prevTotalJiffies;
+    ctx.deltaTotal = (prevTotal > 0 && totalJ > prevTotal) ? (totalJ - prevTotal) : 0;
+    m_prevTotalJiffies = totalJ;
+    ctx.tick = ++m_tick;
+    m_ctx = ctx;
 
-    // Keep list deterministic-ish: sort by CPU descending by default.
-    std::sort(out.begin(), out.end(), [](const ProcInfo& a, const ProcInfo& b){
-        if (a.cpuPercent != b.cpuPercent) return a.cpuPercent > b.cpuPercent;
-        return a.pid < b.pid;
-    });
-
-    // Prune prev map for dead pids occasionally (cheap O(n) for our out size).
-    {
-        std::unordered_map<int, Prev> next;
-        next.reserve(out.size() * 2 + 64);
-        for (const auto& p : out) {
-            auto it = m_prevByPid.find(p.pid);
-            if (it != m_prevByPid.end()) next.emplace(p.pid, it->second);
+    out.clear();
+    m_serial.rows.clear();
+    m_serial.meta.clear();
+    m_workerCpuNs = 0;
+    if (!collectPids()) return;
+
+    if (!m_pool || m_pids.size() < kMinParallelPids) {
+        scanRange(m_reader, m_pids.data(), m_pids.data() + m_pids.size(), ctx, m_serial);
+    } else {
+        // Parse phase: contiguous PID shards, each into its own buffer.
+        const size_t nShards = m_shards.size();
+        const size_t perShard = (m_pids.size() + nShards - 1) / nShards;
+        const unsigned long long workerCpu0 = m_pool->workerCpuNs();
+        m_pool->run((int)nShards, [&](int task, int worker) {
+            Shard& shard = m_shards[(size_t)task];
+            shard.rows.clear();
+            shard.meta.clear();
+            const size_t b = std::min(m_pids.size(), (size_t)task * perShard);
+            const size_t e = std::min(m_pids.size(), b + perShard);
+            scanRange(*m_workerReaders[(size_t)worker], m_pids.data() + b, m_pids.data() + e, ctx, shard);
+        });
+        m_workerCpuNs = m_pool->workerCpuNs() - workerCpu0;
+
+        // Merge phase (serial): concatenate in PID order.
+        for (const auto& shard : m_shards) {
+            m_serial.rows.appendTable(shard.rows);
+            m_serial.meta.insert(m_serial.meta.end(), shard.meta.begin(), shard.meta.end());
         }
-        m_prevByPid.swap(next);
     }
 
-    return out;
+    // Per-process state is only written here, after all shards are done.
+    updateState(ctx.tick);
+    // Rows are in PID order: they are next tick's live set.
+    if (m_events) m_pids.assign(m_serial.rows.pid.begin(), m_serial.rows.pid.end());
+
+    // Hand the rows over as they are (display order is the model's job).
+    // The two tables trade buffers, so both keep their capacity.
+    std::swap(out, m_serial.rows);
+}
+
+void ProcSampler::sampleTasks(const std::vector<int>& pids, TaskTable& out) {
+    out.clear();
+    if (pids.empty()) return;
+
+    // Same stat parser and CPU accounting as the process scan; the tick is
+    // the process scan's, so a delta is only taken against last tick.
+    const unsigned tick = m_ctx.tick;
+    StatFields st;
+    for (const int pid : pids) {
+        if (!m_reader.listTasks(pid, m_tids)) continue;   // exited
+        std::sort(m_tids.begin(), m_tids.end());
+        for (const int tid : m_tids) {
+            if (!m_reader.readTaskStat(pid, tid, st)) continue;
+            const long long jiffies = st.utime + st.stime;
+            double cpu = 0.0;
+            const uint32_t slot = m_taskState.findSlot(tid, st.startTime);
+            PidState& e = slot != PidStateTable::kNoSlot ? m_taskState.at(slot)
+                                                          : m_taskState.insert(tid, st.startTime);
+            if (slot != PidStateTable::kNoSlot && e.lastSeen + 1 == tick) {
+                cpu = cpuPercent(jiffies - e.procJiffies, m_ctx);
+            }
+            e.procJiffies = jiffies;
+            e.lastSeen = tick;
+            out.append(pid, tid, st.startTime, cpu, st.state, std::string_view(st.comm, (size_t)st.commLen));
+        }
+    }
+    m_taskState.sweep(tick, std::max<size_t>(kMinSweep, m_taskState.capacity() / kSweepTicks));
 }
 
 } // namespace FrogKill
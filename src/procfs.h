@@ -1,32 +1,120 @@
 #pragma once
-#include <QString>
+#include <memory>
 #include <vector>
-#include <unordered_map>
+
+#include "pid_state_table.h"
+#include "proc_events.h"
+#include "proc_scanner.h"
+#include "proc_table.h"
 
 namespace FrogKill {
 
-struct ProcInfo {
-    int pid{};
-    int ppid{};
-    QString name;
-    QString user;
-    double cpuPercent{0.0};
-    double rssMiB{0.0};
-};
+class WorkerPool;
 
 class ProcSampler {
 public:
-    std::vector<ProcInfo> sample();
+    // `procRoot` is the procfs to sample; anything but "/proc" (e.g. a
+    // synthetic tree for benchmarks) only needs the files read here.
+    explicit ProcSampler(const char* procRoot = "/proc");
+    ~ProcSampler();
+
+    // Number of threads used to parse /proc. 1 (default) scans serially on
+    // the calling thread; 0 picks the number of online CPUs.
+    void setThreads(int threads);
+    int threads() const { return m_threads; }
+
+    // Event-driven mode: the live PID set is maintained from proc connector
+    // events instead of walking /proc every tick; a full walk only happens
+    // to resynchronize after lost events. Needs CAP_NET_ADMIN and the live
+    // /proc as root. Returns whether the mode is active (false = keep
+    // walking /proc).
+    bool setEventDriven(bool enabled);
+    bool eventDriven() const { return m_events != nullptr; }
+    // Full /proc walks done in event-driven mode (initial one included).
+    size_t resyncs() const { return m_resyncs; }
+
+    // Replaces the contents of `out`, in PID order. Pass the same (recycled)
+    // table every tick to avoid allocations: once warm, nothing is allocated
+    // per process (only a few buffers grow, per tick).
+    void sample(ProcTable& out);
+
+    // Threads of `pids` (grouped in that order), with CPU % over the same
+    // interval as the last sample(); call it right after sample(). Thread
+    // counters live in a state table of their own: an empty list costs
+    // nothing, and a thread gets a CPU value from its second consecutive
+    // tick on.
+    void sampleTasks(const std::vector<int>& pids, TaskTable& out);
+
+    // Processes whose cmdline/status were (re-)read in the last sample.
+    size_t lastMetadataReads() const { return m_metadataReads; }
+    // CPU time of the scan's worker threads in the last sample (the calling
+    // thread's share is not included).
+    unsigned long long lastWorkerCpuNs() const { return m_workerCpuNs; }
 
 private:
-    long long readTotalJiffies() const;
+    long long readTotalJiffies();
 
-    struct Prev {
+    // Per-row bookkeeping produced by the parse phase and applied to
+    // m_state in the merge phase.
+    struct RowMeta {
+        uint32_t slot{PidStateTable::kNoSlot};   // existing generation, if any
         long long procJiffies{0};
+        bool reread{false};                      // cmdline/uid were read this tick
+        bool hasCmdline{false};
+        bool kernelThread{false};
+        unsigned char commLen{0};
+        char comm[16]{};
+    };
+
+    // Per-thread output; merged into the final table after the parse phase.
+    struct Shard {
+        ProcTable rows;
+        std::vector<RowMeta> meta;
+    };
+
+    struct TickContext {
+        int cores{1};
+        long pageKb{4};
+        long long deltaTotal{0};
+        unsigned tick{0};
     };
 
+    // Parses [begin, end) into `out`. Only reads m_state, so several shards
+    // may run concurrently; the table is updated in the merge phase.
+    void scanRange(ProcReader& reader, const int* begin, const int* end,
+                   const TickContext& ctx, Shard& out) const;
+    void updateState(unsigned tick);
+    static double cpuPercent(long long deltaJiffies, const TickContext& ctx);
+    // Builds m_pids (and m_forced) for this tick. False if /proc is unreadable.
+    bool collectPids();
+
+    ProcDir m_dir;
+    bool m_liveProc{true};         // root is the kernel's /proc (events apply)
+    ProcReader m_reader{m_dir};
+    std::vector<int> m_pids;
+    std::vector<int> m_pidScratch;
+    unsigned m_tick{0};
+    size_t m_metadataReads{0};
+    unsigned long long m_workerCpuNs{0};
+
+    int m_threads{1};
+    std::unique_ptr<WorkerPool> m_pool;
+    std::vector<std::unique_ptr<ProcReader>> m_workerReaders;
+    std::vector<Shard> m_shards;
+    Shard m_serial;
+
+    std::unique_ptr<ProcEvents> m_events;
+    ProcEvents::Batch m_batch;
+    std::vector<int> m_forced;     // sorted; metadata re-read regardless of backoff
+    bool m_resync{true};
+    size_t m_resyncs{0};
+
     long long m_prevTotalJiffies{0};
-    std::unordered_map<int, Prev> m_prevByPid;
+    PidStateTable m_state;
+
+    TickContext m_ctx;             // of the last sample()
+    PidStateTable m_taskState;     // keyed by (tid, starttime)
+    std::vector<int> m_tids;
 };
 
 } // namespace FrogKill
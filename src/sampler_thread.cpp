@@ -0,0 +1,222 @@
+#include "sampler_thread.h"
+#include "snapshot_file.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include <time.h>
+
+namespace FrogKill {
+
+using Clock = std::chrono::steady_clock;
+
+// Longest the budget may stretch the table interval to.
+static constexpr std::chrono::milliseconds kMaxInterval{60000};
+
+// CPU time of the calling (sampler) thread; the scan workers' share comes
+// from ProcSampler::lastWorkerCpuNs().
+static double threadCpuMs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+SamplerThread::SamplerThread(std::function<void()> notify)
+    : m_notify(std::move(notify)) {
+    m_thread = std::thread([this] { run(); });
+}
+
+SamplerThread::~SamplerThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void SamplerThread::resume() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = false;
+        m_wakeNow = true;
+    }
+    m_cv.notify_all();
+}
+
+void SamplerThread::pause() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = true;
+    }
+    m_cv.notify_all();
+}
+
+void SamplerThread::setIntervalMs(int ms) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_interval = std::chrono::milliseconds(ms > 0 ? ms : 1);
+    }
+    m_cv.notify_all();
+}
+
+void SamplerThread::setHeaderIntervalMs(int ms) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_headerInterval = std::chrono::milliseconds(ms > 0 ? ms : 1);
+    }
+    m_cv.notify_all();
+}
+
+void SamplerThread::setBudget(double fraction) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budget = fraction > 0.0 ? fraction : 0.0;
+    }
+    m_cv.notify_all();
+}
+
+bool SamplerThread::takeHeader(unsigned long long shownSeq, SystemSnapshot& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_headerFresh) return false;
+    m_headerFresh = false;
+    if (m_headerAfter < shownSeq) return false;   // older than the snapshot shown
+    out = m_header;
+    return true;
+}
+
+void SamplerThread::setTaskPids(std::vector<int> pids) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_taskPids = std::move(pids);
+}
+
+void SamplerThread::setRecordPath(std::string path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_recordPath = std::move(path);
+    m_recordChanged = true;
+}
+
+void SamplerThread::requestNow() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeNow = true;
+    }
+    m_cv.notify_all();
+}
+
+void SamplerThread::run() {
+    // Samplers are confined to this thread.
+    ProcSampler procs;
+    SystemSampler sys;
+    SnapshotWriter recorder;
+    std::string recordPath;
+    Snapshot* back = new Snapshot();
+    std::vector<int> taskPids;
+    unsigned long long seq = 0;
+    auto next = Clock::now();
+    auto nextHeader = next;
+    double cpuMs = 0.0;     // smoothed CPU time per table sample
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        if (m_paused) {
+            m_cv.wait(lock, [this] { return m_stop || !m_paused; });
+        } else if (!m_wakeNow) {
+            m_cv.wait_until(lock, std::min(next, nextHeader), [this] { return m_stop || m_paused || m_wakeNow; });
+        }
+        if (m_stop) break;
+        if (m_paused) continue;
+        const auto now = Clock::now();
+        const auto headerInterval = m_headerInterval;
+        if (!m_wakeNow && now < next) {
+            if (now < nextHeader) continue;
+            // Header tick: two small files, no snapshot.
+            lock.unlock();
+            const SystemSnapshot header = sys.sample();
+            lock.lock();
+            m_header = header;
+            m_headerAfter = seq;
+            m_headerFresh = true;
+            nextHeader = now + headerInterval;
+            lock.unlock();
+            if (!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+                m_notify();
+            }
+            lock.lock();
+            continue;
+        }
+        m_wakeNow = false;
+        const auto base = m_interval;
+        const double budget = m_budget;
+        if (taskPids != m_taskPids) taskPids = m_taskPids;
+        const bool reopen = m_recordChanged;
+        if (reopen) recordPath = m_recordPath;
+        m_recordChanged = false;
+        lock.unlock();
+
+        if (reopen) {
+            recorder.close();
+            if (!recordPath.empty() && !recorder.open(recordPath.c_str())) {
+                qWarning() << "Cannot record to" << recordPath.c_str() << ":" << std::strerror(errno);
+            }
+        }
+
+        const int threads = m_pendingScanThreads.exchange(-1);
+        if (threads >= 0) procs.setThreads(threads);
+        const int events = m_pendingEventDriven.exchange(-1);
+        if (events >= 0 && procs.setEventDriven(events != 0) != (events != 0)) {
+            qWarning() << "Proc connector unavailable (needs CAP_NET_ADMIN); scanning /proc every tick.";
+        }
+
+        const auto t0 = Clock::now();
+        const double cpu0 = threadCpuMs();
+        procs.sample(back->procs);
+        back->tree.build(back->procs);
+        procs.sampleTasks(taskPids, back->tasks);
+        back->sys = sys.sample();
+        back->seq = ++seq;
+        back->timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const auto t1 = Clock::now();
+        back->sampleMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if (recorder.isOpen() && !recorder.append(back->procs, back->sys, back->seq, back->timeMs)) {
+            qWarning() << "Recording to" << recordPath.c_str() << "stopped:" << std::strerror(errno);
+        }
+
+        // Budget: space the samples by their recent cost.
+        const double cost = threadCpuMs() - cpu0 + (double)procs.lastWorkerCpuNs() / 1e6;
+        cpuMs = cpuMs > 0.0 ? 0.7 * cpuMs + 0.3 * cost : cost;
+        auto interval = base;
+        if (budget > 0.0) {
+            const auto stretched = std::chrono::milliseconds((long long)std::ceil(cpuMs / budget));
+            interval = std::max(base, std::min(stretched, kMaxInterval));
+        }
+        m_sampleCpuMs.store(cpuMs, std::memory_order_relaxed);
+        m_effectiveMs.store((int)interval.count(), std::memory_order_relaxed);
+
+        back = m_slot.publish(back);
+        if (!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+            m_notify();
+        }
+
+        // Fixed-rate schedule; if this sample overran, drop the ticks it
+        // covered instead of firing them back to back.
+        next = t0 + interval;
+        if (next <= t1) {
+            const auto missed = (t1 - next) / interval + 1;
+            m_skipped.fetch_add((unsigned long long)missed, std::memory_order_relaxed);
+            next += missed * interval;
+        }
+        nextHeader = t1 + headerInterval;
+
+        lock.lock();
+    }
+    delete back;
+}
+
+} // namespace FrogKill
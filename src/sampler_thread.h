@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "procfs.h"
+#include "snapshot.h"
+
+namespace FrogKill {
+
+// Dedicated thread that samples /proc and publishes immutable snapshots into
+// a SnapshotSlot, and samples the system header metrics (CPU/RAM/swap) on a
+// faster schedule of their own.
+//
+// The process table runs at the table interval, stretched when its measured
+// cost would exceed the CPU budget: the interval becomes the recent CPU time
+// per sample divided by the budget (never shorter than the configured one).
+// Header ticks in between only read /proc/stat and /proc/meminfo.
+//
+// `notify` runs on the sampler thread after each publish (snapshot or
+// header); it is coalesced so at most one notification is outstanding until
+// the consumer drains both via acknowledge().
+class SamplerThread {
+public:
+    explicit SamplerThread(std::function<void()> notify);
+    ~SamplerThread();
+    SamplerThread(const SamplerThread&) = delete;
+    SamplerThread& operator=(const SamplerThread&) = delete;
+
+    // Starts or resumes periodic sampling (first sample is immediate).
+    void resume();
+    // Stops sampling without tearing the thread down.
+    void pause();
+
+    // Process table interval.
+    void setIntervalMs(int ms);
+    // Header metrics interval; not faster than the table if larger.
+    void setHeaderIntervalMs(int ms);
+    // CPU the table may use, as a fraction of one core (0 = fixed interval).
+    void setBudget(double fraction);
+    // Applied by the sampler thread at the start of its next tick.
+    void setScanThreads(int threads) { m_pendingScanThreads.store(threads); }
+    void setEventDriven(bool enabled) { m_pendingEventDriven.store(enabled ? 1 : 0); }
+    // Samples as soon as possible (e.g. after a kill or on F5).
+    void requestNow();
+    // Processes whose threads go into Snapshot::tasks from the next tick on
+    // (empty = none, the default).
+    void setTaskPids(std::vector<int> pids);
+    // Appends every snapshot to a recording at `path` from the next tick on
+    // (see SnapshotWriter); an empty path stops recording.
+    void setRecordPath(std::string path);
+
+    SnapshotSlot& slot() { return m_slot; }
+    // Consumer side: re-arms the notification after draining the slot.
+    void acknowledge() { m_notifyPending.store(false, std::memory_order_release); }
+
+    // Header metrics sampled after snapshot `shownSeq`, if any were
+    // published since the last call.
+    bool takeHeader(unsigned long long shownSeq, SystemSnapshot& out);
+
+    // Ticks dropped because a sample overran its interval.
+    unsigned long long skippedTicks() const { return m_skipped.load(std::memory_order_relaxed); }
+    // Current table interval, after stretching for the budget.
+    int effectiveIntervalMs() const { return m_effectiveMs.load(std::memory_order_relaxed); }
+    // Recent CPU time per table sample (smoothed).
+    double sampleCpuMs() const { return m_sampleCpuMs.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::function<void()> m_notify;
+    SnapshotSlot m_slot;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop{false};
+    bool m_paused{true};
+    bool m_wakeNow{false};
+    std::chrono::milliseconds m_interval{1000};
+    std::chrono::milliseconds m_headerInterval{1000};
+    double m_budget{0.0};
+    // Latest header-only sample and the snapshot it followed.
+    SystemSnapshot m_header;
+    unsigned long long m_headerAfter{0};
+    bool m_headerFresh{false};
+    std::vector<int> m_taskPids;
+    std::string m_recordPath;
+    bool m_recordChanged{false};
+
+    std::atomic<int> m_pendingScanThreads{-1};
+    std::atomic<int> m_pendingEventDriven{-1};
+    std::atomic<bool> m_notifyPending{false};
+    std::atomic<unsigned long long> m_skipped{0};
+    std::atomic<int> m_effectiveMs{1000};
+    std::atomic<double> m_sampleCpuMs{0.0};
+
+    std::thread m_thread;
+};
+
+} // namespace FrogKill
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+
+#include "proc_index.h"
+#include "proc_table.h"
+#include "system_sampler.h"
+
+namespace FrogKill {
+
+// One complete sample. Immutable once published; recycled (with its
+// buffers' capacity) through SnapshotSlot.
+struct Snapshot {
+    ProcTable procs;
+    ProcIndex tree;         // parent/child index of `procs`
+    TaskTable tasks;        // threads of the watched processes, if any
+    SystemSnapshot sys;
+    unsigned long long seq{0};
+    long long timeMs{0};    // wall clock when sampled (ms since the epoch)
+    double sampleMs{0.0};   // wall time spent producing this snapshot
+};
+
+// Lock-free single-producer/single-consumer "latest value" slot.
+//
+// The producer fills a back buffer and publishes it; the consumer takes the
+// newest one and hands its previous front buffer back for reuse. If the
+// consumer falls behind, unconsumed snapshots are overwritten (and recycled)
+// rather than queued. In steady state two buffers circulate.
+class SnapshotSlot {
+public:
+    SnapshotSlot() = default;
+    SnapshotSlot(const SnapshotSlot&) = delete;
+    SnapshotSlot& operator=(const SnapshotSlot&) = delete;
+
+    ~SnapshotSlot() {
+        delete m_latest.exchange(nullptr);
+        delete m_spare.exchange(nullptr);
+    }
+
+    // Producer: publishes `filled` and returns the buffer to fill next.
+    Snapshot* publish(Snapshot* filled) {
+        if (Snapshot* stale = m_latest.exchange(filled, std::memory_order_acq_rel)) {
+            return stale;   // never seen by the consumer; reuse it directly
+        }
+        if (Snapshot* spare = m_spare.exchange(nullptr, std::memory_order_acq_rel)) {
+            return spare;
+        }
+        return new Snapshot();
+    }
+
+    // Consumer: newest snapshot since the last take(), or nullptr.
+    Snapshot* take() {
+        return m_latest.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    // Consumer: returns a snapshot it no longer references.
+    void release(Snapshot* s) {
+        if (!s) return;
+        delete m_spare.exchange(s, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<Snapshot*> m_latest{nullptr};
+    std::atomic<Snapshot*> m_spare{nullptr};
+};
+
+} // namespace FrogKill
@@ -0,0 +1,578 @@
+#include "snapshot_file.h"
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'R', 'O', 'G', 'R', 'E', 'C', '\0'};
+constexpr char kIndexMagic[4] = {'F', 'K', 'I', 'X'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 16;        // magic, u32 version, u32 reserved
+constexpr size_t kFrameHeaderSize = 13;   // u32 size, u8 kind, i64 time
+constexpr size_t kTrailerSize = 16;       // u64 index offset, u32 frames, magic
+
+constexpr uint8_t kKeyframe = 'K';
+constexpr uint8_t kDelta = 'D';
+constexpr uint8_t kIndex = 'I';
+
+// Row ops: the top two bits of the op byte. Keep/Drop carry a run length
+// in the low six bits (0 = a varint follows), Change its field mask.
+enum Op : uint8_t { OpKeep = 0, OpDrop = 1, OpChange = 2, OpAdd = 3 };
+enum Field : uint8_t {
+    FieldCpu = 1 << 0,
+    FieldRss = 1 << 1,
+    FieldPpid = 1 << 2,
+    FieldUid = 1 << 3,
+    FieldName = 1 << 4,
+    FieldUser = 1 << 5,
+};
+
+void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+void putSigned(std::vector<uint8_t>& out, int64_t v) {
+    putVarint(out, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+void putFixed(uint8_t* p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+uint64_t getFixed(const uint8_t* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+void putRun(std::vector<uint8_t>& out, Op op, uint64_t n) {
+    if (n < 64) {
+        out.push_back((uint8_t)(op << 6 | n));
+    } else {
+        out.push_back((uint8_t)(op << 6));
+        putVarint(out, n);
+    }
+}
+
+// Bounds-checked payload reader; any overrun clears `ok`.
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok{true};
+
+    bool atEnd() const { return p >= end; }
+    uint8_t byte() {
+        if (p >= end) {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t b = byte();
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t signedVarint() {
+        const uint64_t v = varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+};
+
+uint64_t quantize(double v, double scale) {
+    return v > 0.0 ? (uint64_t)std::llround(v * scale) : 0;
+}
+
+} // namespace
+
+// --- SnapshotWriter -------------------------------------------------------
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+bool SnapshotWriter::open(const char* path) {
+    close();
+    m_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) return false;
+    m_frames = 0;
+    m_keys.clear();
+    m_prev.clear();
+
+    uint8_t header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putFixed(header + 8, kVersion, 4);
+    m_offset = 0;
+    if (!writeAll(header, sizeof(header))) return false;
+    return true;
+}
+
+void SnapshotWriter::close() {
+    if (m_fd < 0) return;
+    // Index: keyframe positions, delta-coded.
+    m_buf.assign(kFrameHeaderSize, 0);
+    putVarint(m_buf, m_keys.size());
+    size_t prevFrame = 0;
+    unsigned long long prevOffset = 0;
+    for (const Key& k : m_keys) {
+        putVarint(m_buf, k.frame - prevFrame);
+        putVarint(m_buf, k.offset - prevOffset);
+        prevFrame = k.frame;
+        prevOffset = k.offset;
+    }
+    putFixed(m_buf.data(), m_buf.size() - kFrameHeaderSize, 4);
+    m_buf[4] = kIndex;
+
+    const unsigned long long indexOffset = m_offset;
+    uint8_t trailer[kTrailerSize];
+    putFixed(trailer, indexOffset, 8);
+    putFixed(trailer + 8, m_frames, 4);
+    std::memcpy(trailer + 12, kIndexMagic, sizeof(kIndexMagic));
+    if (writeAll(m_buf.data(), m_buf.size())) writeAll(trailer, sizeof(trailer));
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+}
+
+bool SnapshotWriter::writeAll(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        const ssize_t n = ::write(m_fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            // Without the index the frames written so far remain readable.
+            const int err = n < 0 ? errno : ENOSPC;
+            ::close(m_fd);
+            m_fd = -1;
+            errno = err;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+        m_offset += (unsigned long long)n;
+    }
+    return true;
+}
+
+uint32_t SnapshotWriter::intern(std::string_view s) {
+    const auto it = m_ids.find(s);
+    if (it != m_ids.end()) return it->second;
+    const uint32_t id = (uint32_t)m_strings.size();
+    const auto [pos, inserted] = m_ids.emplace(std::string(s), id);
+    m_strings.push_back(&pos->first);
+    m_newStrings.push_back(id);
+    return id;
+}
+
+void SnapshotWriter::encodeRows(const ProcTable& t) {
+    const size_t n = t.size();
+    // The sampler already emits PID order; anything else is sorted here.
+    m_order.resize(n);
+    for (uint32_t r = 0; r < (uint32_t)n; ++r) m_order[r] = r;
+    if (!std::is_sorted(t.pid.begin(), t.pid.end())) {
+        std::sort(m_order.begin(), m_order.end(), [&t](uint32_t a, uint32_t b) { return t.pid[a] < t.pid[b]; });
+    }
+
+    m_cur.clear();
+    m_ops.clear();
+    Op runOp = OpKeep;
+    uint64_t run = 0;
+    auto extend = [&](Op op) {
+        if (run && runOp != op) {
+            putRun(m_ops, runOp, run);
+            run = 0;
+        }
+        runOp = op;
+        ++run;
+    };
+    auto flush = [&] {
+        if (run) putRun(m_ops, runOp, run);
+        run = 0;
+    };
+
+    int lastPid = 0;
+    auto add = [&](uint32_t r) {
+        flush();
+        Row row{t.pid[r], t.ppid[r], t.startTime[r], quantize(t.cpuPercent[r], 100.0),
+                quantize(t.rssMiB[r], 1024.0), t.uid[r], intern(t.name(r)), intern(t.user(r))};
+        m_ops.push_back((uint8_t)(OpAdd << 6));
+        putVarint(m_ops, (uint64_t)(row.pid - lastPid));
+        putSigned(m_ops, (int64_t)row.pid - row.ppid);
+        putVarint(m_ops, row.startTime);
+        putVarint(m_ops, row.cpuCenti);
+        putVarint(m_ops, row.rssKib);
+        putVarint(m_ops, row.uid);
+        putVarint(m_ops, row.name);
+        putVarint(m_ops, row.user);
+        m_cur.push_back(row);
+        lastPid = row.pid;
+    };
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < m_prev.size() || j < n) {
+        const uint32_t r = j < n ? m_order[j] : 0;
+        if (j == n || (i < m_prev.size() && m_prev[i].pid < t.pid[r])) {
+            extend(OpDrop);
+            ++i;
+            continue;
+        }
+        if (i == m_prev.size() || t.pid[r] < m_prev[i].pid) {
+            add(r);
+            ++j;
+            continue;
+        }
+        const Row& old = m_prev[i++];
+        ++j;
+        if (old.startTime != t.startTime[r]) {
+            // PID reused by a new process.
+            extend(OpDrop);
+            add(r);
+            continue;
+        }
+
+        Row row = old;
+        uint8_t mask = 0;
+        row.cpuCenti = quantize(t.cpuPercent[r], 100.0);
+        row.rssKib = quantize(t.rssMiB[r], 1024.0);
+        row.ppid = t.ppid[r];
+        row.uid = t.uid[r];
+        if (row.cpuCenti != old.cpuCenti) mask |= FieldCpu;
+        if (row.rssKib != old.rssKib) mask |= FieldRss;
+        if (row.ppid != old.ppid) mask |= FieldPpid;
+        if (row.uid != old.uid) mask |= FieldUid;
+        if (t.name(r) != *m_strings[old.name]) {
+            row.name = intern(t.name(r));
+            mask |= FieldName;
+        }
+        if (t.user(r) != *m_strings[old.user]) {
+            row.user = intern(t.user(r));
+            mask |= FieldUser;
+        }
+        m_cur.push_back(row);
+        lastPid = row.pid;
+        if (!mask) {
+            extend(OpKeep);
+            continue;
+        }
+
+        flush();
+        m_ops.push_back((uint8_t)(OpChange << 6 | mask));
+        if (mask & FieldCpu) putSigned(m_ops, (int64_t)(row.cpuCenti - old.cpuCenti));
+        if (mask & FieldRss) putSigned(m_ops, (int64_t)(row.rssKib - old.rssKib));
+        if (mask & FieldPpid) putSigned(m_ops, (int64_t)row.ppid - old.ppid);
+        if (mask & FieldUid) putVarint(m_ops, row.uid);
+        if (mask & FieldName) putVarint(m_ops, row.name);
+        if (mask & FieldUser) putVarint(m_ops, row.user);
+    }
+    flush();
+}
+
+bool SnapshotWriter::append(const ProcTable& procs, const SystemSnapshot& sys, unsigned long long seq,
+                            long long timeMs) {
+    if (m_fd < 0) return false;
+
+    const bool key = m_frames % m_keyInterval == 0;
+    if (key) {
+        m_prev.clear();
+        m_ids.clear();
+        m_strings.clear();
+    }
+    m_newStrings.clear();
+    encodeRows(procs);
+
+    m_buf.assign(kFrameHeaderSize, 0);
+    m_buf[4] = key ? kKeyframe : kDelta;
+    putFixed(m_buf.data() + 5, (uint64_t)timeMs, 8);
+    if (key) putVarint(m_buf, seq);
+    else putSigned(m_buf, (int64_t)(seq - m_prevSeq));
+    putVarint(m_buf, quantize(sys.cpuPercent, 100.0));
+    putVarint(m_buf, quantize(sys.memUsedMiB, 1024.0));
+    putVarint(m_buf, quantize(sys.memTotalMiB, 1024.0));
+    putVarint(m_buf, quantize(sys.swapUsedMiB, 1024.0));
+    putVarint(m_buf, quantize(sys.swapTotalMiB, 1024.0));
+    putVarint(m_buf, m_newStrings.size());
+    for (const uint32_t id : m_newStrings) {
+        const std::string& s = *m_strings[id];
+        putVarint(m_buf, s.size());
+        m_buf.insert(m_buf.end(), s.begin(), s.end());
+    }
+    putVarint(m_buf, m_cur.size());
+    m_buf.insert(m_buf.end(), m_ops.begin(), m_ops.end());
+    putFixed(m_buf.data(), m_buf.size() - kFrameHeaderSize, 4);
+
+    const unsigned long long offset = m_offset;
+    if (!writeAll(m_buf.data(), m_buf.size())) return false;
+    if (key) m_keys.push_back({m_frames, offset});
+    ++m_frames;
+    m_prev.swap(m_cur);
+    m_prevSeq = seq;
+    return true;
+}
+
+// --- SnapshotReader -------------------------------------------------------
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+void SnapshotReader::close() {
+    if (m_data) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_keys.clear();
+    m_frameCount = 0;
+    m_current = (size_t)-1;
+}
+
+bool SnapshotReader::open(const char* path, std::string* error) {
+    close();
+    auto fail = [error](const char* why) {
+        if (error) *error = why;
+        return false;
+    };
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail(std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (size_t)st.st_size < kHeaderSize) {
+        ::close(fd);
+        return fail("not a FrogKill recording");
+    }
+    void* map = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return fail(std::strerror(errno));
+    m_data = static_cast<const uint8_t*>(map);
+    m_size = (size_t)st.st_size;
+
+    if (std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+        close();
+        return fail("not a FrogKill recording");
+    }
+    if (getFixed(m_data + 8, 4) != kVersion) {
+        close();
+        return fail("unsupported recording version");
+    }
+    if (!loadIndex()) scanFrames();
+    if (m_frameCount == 0) {
+        close();
+        return fail("the recording has no frames");
+    }
+    return true;
+}
+
+bool SnapshotReader::loadIndex() {
+    if (m_size < kHeaderSize + kFrameHeaderSize + kTrailerSize) return false;
+    const uint8_t* trailer = m_data + m_size - kTrailerSize;
+    if (std::memcmp(trailer + 12, kIndexMagic, sizeof(kIndexMagic)) != 0) return false;
+    const uint64_t indexOffset = getFixed(trailer, 8);
+    const size_t frames = (size_t)getFixed(trailer + 8, 4);
+    if (indexOffset < kHeaderSize || indexOffset + kFrameHeaderSize > m_size - kTrailerSize) return false;
+
+    const uint8_t* h = m_data + indexOffset;
+    const uint64_t len = getFixed(h, 4);
+    if (h[4] != kIndex || indexOffset + kFrameHeaderSize + len != m_size - kTrailerSize) return false;
+
+    Cursor c{h + kFrameHeaderSize, h + kFrameHeaderSize + len};
+    const uint64_t count = c.varint();
+    if (!c.ok || count > frames) return false;
+    m_keys.clear();
+    size_t frame = 0;
+    size_t offset = 0;
+    for (uint64_t k = 0; k < count; ++k) {
+        frame += (size_t)c.varint();
+        offset += (size_t)c.varint();
+        if (!c.ok || frame >= frames || offset + kFrameHeaderSize > indexOffset) return false;
+        if (!m_keys.empty() && frame <= m_keys.back().frame) return false;
+        m_keys.push_back({frame, offset});
+    }
+    if (m_keys.empty() || m_keys.front().frame != 0) return false;
+    m_frameCount = frames;
+    return true;
+}
+
+void SnapshotReader::scanFrames() {
+    // Unclosed file: walk the frames up to the first incomplete one.
+    m_keys.clear();
+    m_frameCount = 0;
+    size_t off = kHeaderSize;
+    while (off + kFrameHeaderSize <= m_size) {
+        const size_t len = (size_t)getFixed(m_data + off, 4);
+        const uint8_t kind = m_data[off + 4];
+        if (len > m_size - off - kFrameHeaderSize) break;
+        if (kind == kKeyframe) m_keys.push_back({m_frameCount, off});
+        else if (kind != kDelta || m_keys.empty()) break;
+        ++m_frameCount;
+        off += kFrameHeaderSize + len;
+    }
+}
+
+size_t SnapshotReader::offsetOf(size_t i) const {
+    auto it = std::upper_bound(m_keys.begin(), m_keys.end(), i,
+                               [](size_t frame, const Key& k) { return frame < k.frame; });
+    --it;   // m_keys[0] is frame 0
+    size_t off = it->offset;
+    for (size_t f = it->frame; f < i && off + kFrameHeaderSize <= m_size; ++f) {
+        off += kFrameHeaderSize + (size_t)getFixed(m_data + off, 4);
+    }
+    return off;
+}
+
+long long SnapshotReader::frameTimeMs(size_t i) const {
+    if (i >= m_frameCount) return 0;
+    const size_t off = offsetOf(i);
+    if (off + kFrameHeaderSize > m_size) return 0;
+    return (long long)getFixed(m_data + off + 5, 8);
+}
+
+bool SnapshotReader::decode(size_t offset) {
+    if (offset + kFrameHeaderSize > m_size) return false;
+    const uint8_t* h = m_data + offset;
+    const size_t len = (size_t)getFixed(h, 4);
+    if (len > m_size - offset - kFrameHeaderSize) return false;
+    if (h[4] != kKeyframe && h[4] != kDelta) return false;
+    Cursor c{h + kFrameHeaderSize, h + kFrameHeaderSize + len};
+    const bool key = h[4] == kKeyframe;
+    if (key) {
+        m_rows.clear();
+        m_text.clear();
+        m_textOff.assign(1, 0);
+        m_seq = c.varint();
+    } else {
+        m_seq += (unsigned long long)c.signedVarint();
+    }
+    m_timeMs = (long long)getFixed(h + 5, 8);
+    m_sys.cpuPercent = (double)c.varint() / 100.0;
+    m_sys.memUsedMiB = (double)c.varint() / 1024.0;
+    m_sys.memTotalMiB = (double)c.varint() / 1024.0;
+    m_sys.swapUsedMiB = (double)c.varint() / 1024.0;
+    m_sys.swapTotalMiB = (double)c.varint() / 1024.0;
+
+    const uint64_t newStrings = c.varint();
+    for (uint64_t k = 0; k < newStrings && c.ok; ++k) {
+        const uint64_t n = c.varint();
+        if (n > (uint64_t)(c.end - c.p)) return false;
+        m_text.insert(m_text.end(), c.p, c.p + n);
+        m_textOff.push_back((uint32_t)m_text.size());
+        c.p += n;
+    }
+    const uint64_t rows = c.varint();
+    const uint64_t strings = m_textOff.size() - 1;
+    if (!c.ok) return false;
+
+    m_next.clear();
+    m_next.reserve(std::min<size_t>((size_t)rows, m_rows.size() + len));
+    size_t i = 0;
+    int lastPid = 0;
+    while (c.ok && !c.atEnd()) {
+        const uint8_t b = c.byte();
+        const uint8_t arg = b & 63;
+        switch ((Op)(b >> 6)) {
+        case OpKeep:
+        case OpDrop: {
+            const uint64_t n = arg ? arg : c.varint();
+            if (n > m_rows.size() - i) return false;
+            if ((Op)(b >> 6) == OpKeep) m_next.insert(m_next.end(), m_rows.begin() + (ptrdiff_t)i, m_rows.begin() + (ptrdiff_t)(i + n));
+            i += (size_t)n;
+            break;
+        }
+        case OpChange: {
+            if (i >= m_rows.size() || !arg) return false;
+            Row row = m_rows[i++];
+            if (arg & FieldCpu) row.cpuCenti += (uint64_t)c.signedVarint();
+            if (arg & FieldRss) row.rssKib += (uint64_t)c.signedVarint();
+            if (arg & FieldPpid) row.ppid = (int)(row.ppid + c.signedVarint());
+            if (arg & FieldUid) row.uid = (uid_t)c.varint();
+            if (arg & FieldName) row.name = (uint32_t)c.varint();
+            if (arg & FieldUser) row.user = (uint32_t)c.varint();
+            m_next.push_back(row);
+            break;
+        }
+        case OpAdd: {
+            Row row;
+            row.pid = lastPid + (int)c.varint();
+            row.ppid = (int)(row.pid - c.signedVarint());
+            row.startTime = c.varint();
+            row.cpuCenti = c.varint();
+            row.rssKib = c.varint();
+            row.uid = (uid_t)c.varint();
+            row.name = (uint32_t)c.varint();
+            row.user = (uint32_t)c.varint();
+            m_next.push_back(row);
+            break;
+        }
+        }
+        if (m_next.empty()) continue;
+        const Row& last = m_next.back();
+        if (last.name >= strings || last.user >= strings) return false;
+        lastPid = last.pid;
+    }
+    // Rows not mentioned at the end of the previous frame are gone.
+    if (!c.ok || m_next.size() != rows) return false;
+    m_rows.swap(m_next);
+    m_nextOffset = offset + kFrameHeaderSize + len;
+    return true;
+}
+
+bool SnapshotReader::read(size_t i, Snapshot& out) {
+    if (i >= m_frameCount) return false;
+    if (i != m_current) {
+        bool ok = true;
+        if (m_current != (size_t)-1 && i == m_current + 1) {
+            ok = decode(m_nextOffset);
+        } else {
+            auto it = std::upper_bound(m_keys.begin(), m_keys.end(), i,
+                                       [](size_t frame, const Key& k) { return frame < k.frame; });
+            --it;
+            // Already between that keyframe and `i`: just go on from here.
+            size_t f = it->frame;
+            size_t off = it->offset;
+            if (m_current != (size_t)-1 && m_current >= f && m_current < i) {
+                f = m_current + 1;
+                off = m_nextOffset;
+            }
+            for (; ok && f <= i; ++f) {
+                ok = decode(off);
+                off = m_nextOffset;
+            }
+        }
+        m_current = ok ? i : (size_t)-1;
+        if (!ok) return false;
+    }
+
+    ProcTable& t = out.procs;
+    t.clear();
+    const auto str = [this](uint32_t id) {
+        return std::string_view(m_text.data() + m_textOff[id], m_textOff[id + 1] - m_textOff[id]);
+    };
+    for (const Row& r : m_rows) {
+        t.append(r.pid, r.ppid, r.startTime, (double)r.cpuCenti / 100.0, (double)r.rssKib / 1024.0, r.uid,
+                 str(r.name), str(r.user));
+    }
+    out.tree.build(t);
+    out.tasks.clear();
+    out.sys = m_sys;
+    out.seq = m_seq;
+    out.timeMs = m_timeMs;
+    return true;
+}
+
+} // namespace FrogKill
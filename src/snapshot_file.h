@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
+
+#include "proc_table.h"
+#include "system_sampler.h"
+
+namespace FrogKill {
+
+struct Snapshot;
+
+namespace SnapshotFormat {
+
+// One process as stored (quantized). Strings are string table ids.
+struct Row {
+    int pid;
+    int ppid;
+    unsigned long long startTime;
+    uint64_t cpuCenti;
+    uint64_t rssKib;
+    uid_t uid;
+    uint32_t name;
+    uint32_t user;
+};
+
+} // namespace SnapshotFormat
+
+// Recording of a sampling session (`--record`), one frame per snapshot.
+//
+// Layout: a 16-byte header, the frames, then (once the writer is closed)
+// a keyframe index and a 16-byte trailer pointing at it. A frame is
+// [u32 payload size][u8 kind][i64 wall-clock ms][payload]; a keyframe
+// ('K') stands alone, a delta ('D') applies to the frame before it.
+// Integers in payloads are LEB128 varints, signed ones zigzag-encoded.
+//
+// Rows are matched between frames by (pid, starttime), walking both tables
+// in PID order: a run of unchanged rows costs one byte, a changed row a
+// field mask plus the changed fields, a new one its full row. Command lines
+// and user names go into a string table on first use and are referenced by
+// number after that; keyframes restart the table, so decoding can start at
+// any keyframe. CPU is stored in hundredths of a percent and RSS in KiB,
+// finer than the views show.
+//
+// A file whose writer never closed it (crash, power loss) still replays:
+// the reader rebuilds the index by walking the frames, up to the last
+// complete one.
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    // Creates (or truncates) `path`. False with errno set on failure.
+    bool open(const char* path);
+    bool isOpen() const { return m_fd >= 0; }
+    // Writes the keyframe index and closes the file (the destructor does
+    // it too).
+    void close();
+
+    // A keyframe every `frames` frames (default 120): a longer interval
+    // makes files smaller and seeking slower.
+    void setKeyframeInterval(unsigned frames) { m_keyInterval = frames ? frames : 1; }
+
+    // Appends one frame; `timeMs` is the wall-clock time of the sample (ms
+    // since the epoch). False on a write error (the file is closed then).
+    bool append(const ProcTable& procs, const SystemSnapshot& sys, unsigned long long seq, long long timeMs);
+
+    size_t frames() const { return m_frames; }
+    unsigned long long bytesWritten() const { return m_offset; }
+
+private:
+    using Row = SnapshotFormat::Row;
+
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    // Id of `s` in the string table, adding it to this frame if new.
+    uint32_t intern(std::string_view s);
+    void encodeRows(const ProcTable& procs);
+    bool writeAll(const uint8_t* data, size_t len);
+
+    int m_fd{-1};
+    unsigned m_keyInterval{120};
+    size_t m_frames{0};
+    unsigned long long m_offset{0};
+    struct Key {
+        size_t frame;
+        unsigned long long offset;
+    };
+    std::vector<Key> m_keys;
+
+    std::unordered_map<std::string, uint32_t, Hash, std::equal_to<>> m_ids;
+    std::vector<const std::string*> m_strings;   // by id (keys of m_ids)
+    std::vector<uint32_t> m_newStrings;          // ids first used in this frame
+
+    std::vector<Row> m_prev;                     // last frame's rows, PID order
+    std::vector<Row> m_cur;
+    std::vector<uint32_t> m_order;               // procs rows in PID order
+    unsigned long long m_prevSeq{0};
+
+    std::vector<uint8_t> m_ops;                  // scratch: the frame's row ops
+    std::vector<uint8_t> m_buf;                  // scratch: the whole frame
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader() = default;
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    // Maps `path`. On failure `error` (if given) gets a short reason.
+    bool open(const char* path, std::string* error = nullptr);
+    void close();
+
+    size_t frameCount() const { return m_frameCount; }
+    // Wall-clock time of frame `i` (ms since the epoch); 0 if out of range.
+    long long frameTimeMs(size_t i) const;
+
+    // Decodes frame `i` into `out` (procs, tree, sys, seq and timeMs; no
+    // tasks). The frame right after the last one read costs one delta; any
+    // other jump decodes forward from the nearest keyframe at or before it.
+    bool read(size_t i, Snapshot& out);
+
+private:
+    using Row = SnapshotFormat::Row;
+
+    struct Key {
+        size_t frame;
+        size_t offset;
+    };
+
+    bool loadIndex();
+    void scanFrames();
+    // Offset of frame `i`'s header (hops from the keyframe before it).
+    size_t offsetOf(size_t i) const;
+    // Applies the frame at `offset` to m_rows; false if it is malformed.
+    bool decode(size_t offset);
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    std::vector<Key> m_keys;
+    size_t m_frameCount{0};
+
+    // Decoder state: rows and strings as of frame m_current.
+    size_t m_current{(size_t)-1};
+    size_t m_nextOffset{0};
+    std::vector<Row> m_rows;
+    std::vector<Row> m_next;
+    std::vector<char> m_text;                    // string table contents
+    std::vector<uint32_t> m_textOff;             // id -> [off, next off)
+    unsigned long long m_seq{0};
+    long long m_timeMs{0};
+    SystemSnapshot m_sys;
+};
+
+} // namespace FrogKill
@@ -0,0 +1,106 @@
+#include "sparkline_delegate.h"
+#include "proc_history.h"
+#include "process_model.h"
+
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace FrogKill {
+
+SparklineDelegate::SparklineDelegate(const ProcHistory* history, QObject* parent)
+    : QStyledItemDelegate(parent), m_history(history) {}
+
+static ProcHistory::Series seriesAt(const ProcHistory* history, const QModelIndex& index) {
+    bool ok = false;
+    const uint row = index.data(RowRole).toUInt(&ok);
+    return ok ? history->series(history->slotOfRow(row)) : ProcHistory::Series{};
+}
+
+void SparklineDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    // Background, selection and focus as for any other cell.
+    QStyleOptionViewItem opt(option);
+    initStyleOption(&opt, index);
+    QStyle* style = opt.widget ? opt.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+    const ProcHistory::Series s = seriesAt(m_history, index);
+    if (s.count < 2) return;
+
+    // Newest sample at the right edge; a young process fills only the
+    // right part of the cell.
+    const QRectF r = QRectF(opt.rect).adjusted(3, 3, -3, -3);
+    if (r.width() < 4 || r.height() < 4) return;
+    const qreal step = r.width() / (qreal)(s.capacity - 1);
+    const qreal x0 = r.right() - step * (qreal)(s.count - 1);
+    m_points.resize(s.count + 2);
+
+    float cpuPeak = 100.0f;
+    float rssMin = s.rssAt(0);
+    float rssMax = rssMin;
+    for (unsigned i = 0; i < s.count; ++i) {
+        cpuPeak = std::max(cpuPeak, s.cpuAt(i));
+        rssMin = std::min(rssMin, s.rssAt(i));
+        rssMax = std::max(rssMax, s.rssAt(i));
+    }
+
+    const bool selected = opt.state & QStyle::State_Selected;
+    const QPalette::ColorRole textRole = selected ? QPalette::HighlightedText : QPalette::Text;
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // CPU: area down to the baseline.
+    m_points[0] = QPointF(x0, r.bottom());
+    for (unsigned i = 0; i < s.count; ++i) {
+        m_points[i + 1] = QPointF(x0 + step * i, r.bottom() - r.height() * (qreal)(s.cpuAt(i) / cpuPeak));
+    }
+    m_points[s.count + 1] = QPointF(r.right(), r.bottom());
+    QColor fill = opt.palette.color(selected ? QPalette::HighlightedText : QPalette::Highlight);
+    fill.setAlpha(110);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(fill);
+    painter->drawPolygon(m_points.data(), (int)s.count + 2);
+
+    // RSS: a line over its own min..max (flat in the middle if constant).
+    const float span = rssMax - rssMin;
+    for (unsigned i = 0; i < s.count; ++i) {
+        const qreal y = span > 0.05f ? r.bottom() - r.height() * (qreal)((s.rssAt(i) - rssMin) / span)
+                                     : r.center().y();
+        m_points[i] = QPointF(x0 + step * i, y);
+    }
+    painter->setPen(QPen(opt.palette.color(textRole), 1.2));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawPolyline(m_points.data(), (int)s.count);
+    painter->restore();
+}
+
+bool SparklineDelegate::helpEvent(QHelpEvent* event, QAbstractItemView* view, const QStyleOptionViewItem& option,
+                                  const QModelIndex& index) {
+    if (event->type() != QEvent::ToolTip) return QStyledItemDelegate::helpEvent(event, view, option, index);
+    const ProcHistory::Series s = seriesAt(m_history, index);
+    if (s.count == 0) {
+        QToolTip::hideText();
+        return true;
+    }
+    float cpuPeak = 0.0f;
+    float cpuSum = 0.0f;
+    for (unsigned i = 0; i < s.count; ++i) {
+        cpuPeak = std::max(cpuPeak, s.cpuAt(i));
+        cpuSum += s.cpuAt(i);
+    }
+    QToolTip::showText(event->globalPos(),
+                       QString("Últimas %1 amostras\nCPU: média %2%, pico %3%\nRAM: %4 → %5 MiB")
+                           .arg(s.count)
+                           .arg(cpuSum / (float)s.count, 0, 'f', 1)
+                           .arg(cpuPeak, 0, 'f', 1)
+                           .arg(s.rssAt(0), 0, 'f', 1)
+                           .arg(s.rssAt(s.count - 1), 0, 'f', 1),
+                       view);
+    return true;
+}
+
+} // namespace FrogKill
@@ -0,0 +1,31 @@
+#pragma once
+#include <QPointF>
+#include <QStyledItemDelegate>
+
+#include <vector>
+
+namespace FrogKill {
+
+class ProcHistory;
+
+// Paints the "Histórico" column straight from ProcHistory: recent CPU as a
+// filled area (0..100%, or the peak if higher) and RSS as a line scaled to
+// its own range, so a slow leak shows as a slope. The row's history is
+// found through RowRole, so `history` must have been updated with the
+// snapshot the model shows.
+class SparklineDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    SparklineDelegate(const ProcHistory* history, QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    // Tooltip with the numbers behind the curves.
+    bool helpEvent(QHelpEvent* event, QAbstractItemView* view, const QStyleOptionViewItem& option,
+                   const QModelIndex& index) override;
+
+private:
+    const ProcHistory* m_history;
+    mutable std::vector<QPointF> m_points;   // scratch, one point per sample
+};
+
+} // namespace FrogKill
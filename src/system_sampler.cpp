@@ -6,9 +6,9 @@
 
 namespace FrogKill {
 
-static bool readCpuLine(unsigned long long& total, unsigned long long& idle) {
+static bool readCpuLine(const char* path, unsigned long long& total, unsigned long long& idle) {
     // Read first line of /proc/stat: cpu  user nice system idle iowait irq softirq steal ...
-    FILE* f = std::fopen("/proc/stat", "r");
+    FILE* f = std::fopen(path, "r");
     if (!f) return false;
     char tag[8] = {0};
     unsigned long long user=0, nice=0, sys=0, idle0=0, iowait=0, irq=0, soft=0, steal=0;
@@ -23,9 +23,9 @@ static bool readCpuLine(unsigned long long& total, unsigned long long& idle) {
     return true;
 }
 
-static void readMemInfo(double& memTotalMiB, double& memUsedMiB, double& swapTotalMiB, double& swapUsedMiB) {
+static void readMemInfo(const char* path, double& memTotalMiB, double& memUsedMiB, double& swapTotalMiB, double& swapUsedMiB) {
     // Parse just what we need from /proc/meminfo. Values are in kB.
-    FILE* f = std::fopen("/proc/meminfo", "r");
+    FILE* f = std::fopen(path, "r");
     if (!f) return;
 
     unsigned long long memTotalKB = 0;
@@ -64,11 +64,14 @@ static void readMemInfo(double& memTotalMiB, double& memUsedMiB, double& swapTot
     }
 }
 
+SystemSampler::SystemSampler(const char* procRoot)
+    : m_statPath(std::string(procRoot) + "/stat"), m_meminfoPath(std::string(procRoot) + "/meminfo") {}
+
 SystemSnapshot SystemSampler::sample() {
     SystemSnapshot s;
 
     unsigned long long total=0, idle=0;
-    if (readCpuLine(total, idle)) {
+    if (readCpuLine(m_statPath.c_str(), total, idle)) {
         if (m_prevTotal != 0 && total > m_prevTotal) {
             const unsigned long long dt = total - m_prevTotal;
             const unsigned long long di = (idle >= m_prevIdle) ? (idle - m_prevIdle) : 0;
@@ -79,7 +82,7 @@ SystemSnapshot SystemSampler::sample() {
         m_prevIdle = idle;
     }
 
-    readMemInfo(s.memTotalMiB, s.memUsedMiB, s.swapTotalMiB, s.swapUsedMiB);
+    readMemInfo(m_meminfoPath.c_str(), s.memTotalMiB, s.memUsedMiB, s.swapTotalMiB, s.swapUsedMiB);
     return s;
 }
 
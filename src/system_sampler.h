@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 namespace FrogKill {
 
@@ -14,9 +15,15 @@ struct SystemSnapshot {
 // Designed to keep allocations and parsing minimal.
 class SystemSampler {
 public:
+    // Reads stat and meminfo under `procRoot`.
+    explicit SystemSampler(const char* procRoot = "/proc");
+
     SystemSnapshot sample();
 
 private:
+    std::string m_statPath;
+    std::string m_meminfoPath;
+
     // CPU deltas
     unsigned long long m_prevTotal{0};
     unsigned long long m_prevIdle{0};
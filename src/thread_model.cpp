@@ -0,0 +1,100 @@
+#include "thread_model.h"
+#include "process_model.h"
+
+#include <string_view>
+
+namespace FrogKill {
+
+static constexpr int kColumns = 5;   // PID, TID, Name, State, CPU
+
+static QString toQString(std::string_view s) {
+    return QString::fromUtf8(s.data(), (qsizetype)s.size());
+}
+
+static QString stateText(char state) {
+    switch (state) {
+        case 'R': return "Executando";
+        case 'S': return "Dormindo";
+        case 'D': return "Aguardando E/S";
+        case 'Z': return "Zumbi";
+        case 'T': return "Parado";
+        case 't': return "Depurado";
+        case 'I': return "Ocioso";
+        case 'X': return "Morto";
+        default: return QString(QLatin1Char(state));
+    }
+}
+
+ThreadModel::ThreadModel(QObject* parent) : QAbstractTableModel(parent) {}
+
+int ThreadModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid() || !m_snap) return 0;
+    return (int)m_snap->tasks.size();
+}
+
+int ThreadModel::columnCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return kColumns;
+}
+
+QVariant ThreadModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+    switch (section) {
+        case 0: return "PID";
+        case 1: return "TID";
+        case 2: return "Thread";
+        case 3: return "Estado";
+        case 4: return "CPU %";
+        default: return {};
+    }
+}
+
+QVariant ThreadModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return {};
+    const TaskTable& t = m_snap->tasks;
+    const size_t i = (size_t)index.row();
+    const int c = index.column();
+
+    if (role == Qt::DisplayRole) {
+        switch (c) {
+            case 0: return t.tgid[i];
+            case 1: return t.tid[i];
+            case 2: return toQString(t.name(i));
+            case 3: return stateText(t.state[i]);
+            case 4: return QString::number(t.cpuPercent[i], 'f', 1);
+        }
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        if (c == 0 || c == 1 || c == 4) return Qt::AlignRight;
+    }
+
+    if (role == SortRole) {
+        switch (c) {
+            case 0: return t.tgid[i];
+            case 1: return t.tid[i];
+            case 2: return toQString(t.name(i));
+            case 3: return stateText(t.state[i]);
+            case 4: return t.cpuPercent[i];
+        }
+    }
+
+    return {};
+}
+
+void ThreadModel::setSnapshot(const Snapshot* snap) {
+    const bool sameThreads = m_snap && snap && m_snap->tasks.tid == snap->tasks.tid
+        && m_snap->tasks.startTime == snap->tasks.startTime;
+    if (!sameThreads) {
+        beginResetModel();
+        m_snap = snap;
+        endResetModel();
+        return;
+    }
+    m_snap = snap;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, 2), index(rowCount() - 1, kColumns - 1), {Qt::DisplayRole});
+    }
+}
+
+} // namespace FrogKill
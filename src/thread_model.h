@@ -0,0 +1,29 @@
+#pragma once
+#include <QAbstractTableModel>
+#include "snapshot.h"
+
+namespace FrogKill {
+
+// Threads of the watched processes (Snapshot::tasks), one row per thread.
+// Rows are the snapshot's own rows: while the thread set stays the same,
+// a tick only signals dataChanged; otherwise the model resets (the list is
+// small and only filled while the thread panel is open).
+class ThreadModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    explicit ThreadModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    // Same contract as ProcessModel::setSnapshot().
+    void setSnapshot(const Snapshot* snap);
+
+private:
+    const Snapshot* m_snap{nullptr};
+};
+
+} // namespace FrogKill
@@ -0,0 +1,430 @@
+#include "tree_kill.h"
+#include "proc_scanner.h"
+#include "proc_tree.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <unordered_set>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace FrogKill {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr const char* kCgroupRoot = "/sys/fs/cgroup";
+// How long to wait for SIGKILL to take effect when verifying.
+static constexpr int kKillWaitMs = 2000;
+// Pause between sweep passes that found nothing new, so pending SIGSTOPs
+// can land.
+static constexpr int kSweepPauseUs = 500;
+
+namespace {
+
+bool readSmallFile(const std::string& path, std::string& out) {
+    out.clear();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[4096];
+    for (;;) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        out.append(buf, (size_t)n);
+    }
+    ::close(fd);
+    return true;
+}
+
+// Returns 0 or the errno of the open/write.
+int writeSmallFile(const std::string& path, const char* value) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return errno;
+    const size_t len = std::strlen(value);
+    const int e = ::write(fd, value, len) == (ssize_t)len ? 0 : errno;
+    ::close(fd);
+    return e;
+}
+
+void parsePids(const std::string& text, std::vector<int>& out) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        int v = 0;
+        const auto r = std::from_chars(p, end, v);
+        if (r.ec == std::errc{}) {
+            out.push_back(v);
+            p = r.ptr;
+        } else {
+            ++p;
+        }
+    }
+}
+
+// cgroup.procs of `dir` and of every cgroup below it.
+bool collectCgroupProcs(const std::string& dir, std::vector<int>& out) {
+    std::string text;
+    if (!readSmallFile(dir + "/cgroup.procs", text)) return false;
+    parsePids(text, out);
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) return true;
+    while (const dirent* e = ::readdir(d)) {
+        if (e->d_type != DT_DIR || e->d_name[0] == '.') continue;
+        collectCgroupProcs(dir + "/" + e->d_name, out);
+    }
+    ::closedir(d);
+    return true;
+}
+
+void thawCgroupDir(const std::string& dir) {
+    writeSmallFile(dir + "/cgroup.freeze", "0");
+}
+
+// Freezing is asynchronous; cgroup.events reports "frozen 1" once every
+// task (including descendant cgroups) has stopped.
+bool freezeCgroupDir(const std::string& dir, Clock::time_point deadline) {
+    if (writeSmallFile(dir + "/cgroup.freeze", "1") != 0) return false;
+    std::string text;
+    for (;;) {
+        if (!readSmallFile(dir + "/cgroup.events", text)) break;
+        if (text.find("frozen 1") != std::string::npos) return true;
+        if (Clock::now() >= deadline) break;
+        ::usleep(kSweepPauseUs);
+    }
+    thawCgroupDir(dir);
+    return false;
+}
+
+class Killer {
+public:
+    Killer(TreeKillResult& result, const std::atomic<bool>* cancel)
+        : m_result(result), m_reader(m_proc), m_cancel(cancel) {
+        m_proc.open("/proc");
+    }
+
+    bool cancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+
+    bool addRoot(int root, unsigned long long rootStart) {
+        ProcHandle h;
+        const int e = h.open(root, rootStart);
+        if (e != 0) {
+            if (e != ESRCH) m_result.error = e;
+            return false;
+        }
+        m_pids.insert(root);
+        m_result.members.push_back(std::move(h));
+        return true;
+    }
+
+    // Binds a handle to the current generation of `pid`. False if it is
+    // already a member, is the caller, or is gone.
+    bool adopt(int pid) {
+        StatFields st;
+        if (pid <= 1 || pid == m_self || m_pids.count(pid) || !m_reader.readStat(pid, st)) return false;
+        ProcHandle h;
+        if (h.open(pid, st.startTime) != 0) return false;
+        m_pids.insert(pid);
+        m_result.members.push_back(std::move(h));
+        return true;
+    }
+
+    // Freezes the root's cgroup if the tree owns it. Returns true if frozen.
+    bool freezeOwnedCgroup(int root, Clock::time_point deadline);
+    // Members run again afterwards: a later sweep has to stop them itself.
+    void thaw() {
+        if (!m_frozenDir.empty()) thawCgroupDir(m_frozenDir);
+        m_frozenDir.clear();
+        m_frozen.clear();
+    }
+
+    // Stops every known member, then repeats passes until one finds no new
+    // descendant and all members are stopped (or frozen). True on fixpoint.
+    bool stopSweep(Clock::time_point deadline);
+
+    // Signals every process of a cgroup subtree: frozen if possible,
+    // otherwise in passes until one finds no new member. True on fixpoint.
+    bool signalCgroup(const std::string& dir, int sig, Clock::time_point deadline);
+
+    void signalAll(int sig, size_t from = 0) {
+        for (size_t i = from; i < m_result.members.size(); ++i) {
+            const int e = m_result.members[i].signal(sig);
+            if (e != 0 && e != ESRCH && m_result.error == 0) m_result.error = e;
+        }
+    }
+
+private:
+    bool isStopped(int pid) {
+        if (m_frozen.count(pid)) return true;
+        StatFields st;
+        if (!m_reader.readStat(pid, st)) return true;     // gone
+        return st.state == 'T' || st.state == 't' || st.state == 'Z' || st.state == 'X';
+    }
+    void collectKids(std::vector<int>& kids);
+
+    TreeKillResult& m_result;
+    ProcDir m_proc;
+    ProcReader m_reader;
+    ChildrenReader m_children;
+    std::unordered_set<int> m_pids;       // all members ever seen
+    std::unordered_set<int> m_frozen;     // members inside the frozen cgroup
+    std::string m_frozenDir;              // non-empty while frozen
+    std::vector<int> m_scratch;
+    const std::atomic<bool>* m_cancel;
+    // Never stopped, even when the caller runs inside the tree it kills.
+    const int m_self{(int)::getpid()};
+};
+
+bool Killer::freezeOwnedCgroup(int root, Clock::time_point deadline) {
+    std::string cg;
+    if (!cgroupOf(root, cg) || cg == "/") return false;
+    const std::string dir = kCgroupRoot + cg;
+
+    // Only freeze a cgroup that holds nothing but this tree.
+    std::vector<TreeNode> nodes;
+    if (!collectSubtree(root, nodes)) return false;
+    std::unordered_set<int> tree;
+    for (const auto& n : nodes) tree.insert(n.pid);
+    m_scratch.clear();
+    if (!collectCgroupProcs(dir, m_scratch)) return false;
+    for (const int pid : m_scratch) {
+        if (pid == m_self || !tree.count(pid)) return false;
+    }
+
+    if (!freezeCgroupDir(dir, deadline)) return false;
+    m_frozenDir = dir;
+
+    // Nothing in the cgroup can fork any more: adopt all of it.
+    m_scratch.clear();
+    collectCgroupProcs(dir, m_scratch);
+    for (const int pid : m_scratch) {
+        m_frozen.insert(pid);
+        adopt(pid);
+    }
+    return true;
+}
+
+void Killer::collectKids(std::vector<int>& kids) {
+    if (m_children.available()) {
+        for (const auto& h : m_result.members) {
+            if (!h.exited()) m_children.read(h.pid(), kids);
+        }
+        return;
+    }
+    // No children files: one /proc scan per pass.
+    if (!m_proc.listPids(m_scratch)) return;
+    StatFields st;
+    for (const int pid : m_scratch) {
+        if (pid == m_self || m_pids.count(pid) || !m_reader.readStat(pid, st)) continue;
+        if (m_pids.count(st.ppid)) kids.push_back(pid);
+    }
+}
+
+bool Killer::stopSweep(Clock::time_point deadline) {
+    for (const auto& h : m_result.members) {
+        if (!m_frozen.count(h.pid())) h.signal(SIGSTOP);
+    }
+
+    std::vector<int> kids;
+    for (;;) {
+        kids.clear();
+        collectKids(kids);
+        bool grew = false;
+        for (const int kid : kids) {
+            if (!adopt(kid)) continue;
+            if (!m_frozen.count(kid)) m_result.members.back().signal(SIGSTOP);
+            grew = true;
+        }
+
+        // A member that has not stopped yet may still fork.
+        bool allStopped = true;
+        for (const auto& h : m_result.members) {
+            if (!h.exited() && !isStopped(h.pid())) {
+                allStopped = false;
+                break;
+            }
+        }
+        if (!grew && allStopped) return true;
+        if (Clock::now() >= deadline || cancelled()) return false;
+        if (!grew) ::usleep(kSweepPauseUs);
+    }
+}
+
+bool Killer::signalCgroup(const std::string& dir, int sig, Clock::time_point deadline) {
+    if (freezeCgroupDir(dir, deadline)) {
+        if (cancelled()) {
+            thawCgroupDir(dir);
+            return false;
+        }
+        m_result.cgroupFrozen = true;
+        m_scratch.clear();
+        collectCgroupProcs(dir, m_scratch);
+        for (const int pid : m_scratch) adopt(pid);
+        signalAll(sig);
+        thawCgroupDir(dir);
+        return true;
+    }
+
+    // No freezer (or no permission to use it): signal in passes.
+    size_t signalled = 0;
+    for (;;) {
+        if (cancelled()) return false;
+        signalAll(sig, signalled);
+        signalled = m_result.members.size();
+        m_scratch.clear();
+        collectCgroupProcs(dir, m_scratch);
+        bool grew = false;
+        for (const int pid : m_scratch) grew |= adopt(pid);
+        if (!grew) return true;
+        if (Clock::now() >= deadline) {
+            if (!cancelled()) signalAll(sig, signalled);
+            return false;
+        }
+    }
+}
+
+size_t waitForExits(const TreeKillResult& result, const TreeKillOptions& opts) {
+    if (opts.graceMs <= 0) return waitAllExit(result.members, 0);
+    const int wait = opts.sig == SIGKILL ? std::max(opts.graceMs, kKillWaitMs) : opts.graceMs;
+    return waitAllExit(result.members, wait);
+}
+
+Clock::time_point deadlineAfter(int ms) {
+    return Clock::now() + std::chrono::milliseconds(std::max(0, ms));
+}
+
+} // namespace
+
+bool cgroupOf(int pid, std::string& path) {
+    // Pure cgroup v2: a single "0::<path>" line and the unified hierarchy
+    // mounted at /sys/fs/cgroup.
+    std::string text;
+    if (!readSmallFile("/proc/" + std::to_string(pid) + "/cgroup", text)) return false;
+    if (text.compare(0, 3, "0::") != 0) return false;
+    const size_t nl = text.find('\n');
+    if (nl != std::string::npos && nl + 1 < text.size()) return false;
+    if (::access((std::string(kCgroupRoot) + "/cgroup.controllers").c_str(), F_OK) != 0) return false;
+    path = text.substr(3, nl == std::string::npos ? std::string::npos : nl - 3);
+    return !path.empty() && path[0] == '/';
+}
+
+bool cgroupMembers(const std::string& path, std::vector<int>& out) {
+    out.clear();
+    return collectCgroupProcs(kCgroupRoot + path, out);
+}
+
+int checkCgroupTarget(const std::string& path, std::vector<int>* members) {
+    if (path.empty() || path[0] != '/' || path == "/" || path.find("/..") != std::string::npos) {
+        return EINVAL;
+    }
+    std::vector<int> local;
+    std::vector<int>& pids = members ? *members : local;
+    if (!cgroupMembers(path, pids)) return ENOENT;
+    const int self = (int)::getpid();
+    for (const int pid : pids) {
+        if (pid == 1) return EINVAL;
+        if (pid == self) return EDEADLK;
+    }
+    return 0;
+}
+
+TreeKillResult killTree(int root, unsigned long long rootStart, const TreeKillOptions& opts) {
+    TreeKillResult result;
+    if (root <= 1 || root == (int)::getpid()) {
+        result.error = EPERM;
+        return result;
+    }
+    Killer killer(result, opts.cancel);
+    if (!killer.addRoot(root, rootStart)) return result;
+
+    const auto freezeDeadline = deadlineAfter(opts.freezeTimeoutMs);
+    result.cgroupFrozen = opts.allowCgroupFreeze && killer.freezeOwnedCgroup(root, freezeDeadline);
+    result.converged = killer.stopSweep(freezeDeadline);
+    if (killer.cancelled()) {
+        // Nothing was signalled yet: let the tree run again as it was.
+        killer.signalAll(SIGCONT);
+        killer.thaw();
+        result.error = ECANCELED;
+        result.members.clear();
+        return result;
+    }
+
+    // Frozen set: final signal, then SIGCONT (a stopped process only acts
+    // on SIGTERM once continued; SIGCONT also drops pending SIGSTOPs).
+    killer.signalAll(opts.sig);
+    result.signalled = result.members.size();
+    killer.signalAll(SIGCONT);
+    killer.thaw();
+
+    result.survivors = waitForExits(result, opts);
+    if (result.survivors == 0 || opts.sig == SIGKILL || opts.graceMs <= 0) return result;
+
+    // Escalation: survivors ran again after SIGCONT and may have forked;
+    // freeze once more and finish with SIGKILL (it reaches frozen tasks).
+    const auto escalateDeadline = deadlineAfter(opts.freezeTimeoutMs);
+    if (result.cgroupFrozen) killer.freezeOwnedCgroup(root, escalateDeadline);
+    if (!killer.stopSweep(escalateDeadline)) result.converged = false;
+    killer.signalAll(SIGKILL);
+    result.signalled = result.members.size();
+    killer.thaw();
+    result.survivors = waitAllExit(result.members, kKillWaitMs);
+    return result;
+}
+
+TreeKillResult killCgroup(int pid, unsigned long long startTime, const TreeKillOptions& opts, std::string& path) {
+    TreeKillResult result;
+    if (pid <= 1) {
+        result.error = EINVAL;
+        return result;
+    }
+    Killer killer(result, opts.cancel);
+    if (!killer.addRoot(pid, startTime)) return result;
+    if (!cgroupOf(pid, path)) {
+        result.error = EOPNOTSUPP;
+        return result;
+    }
+    std::vector<int> pids;
+    if (const int e = checkCgroupTarget(path, &pids); e != 0) {
+        result.error = e;
+        return result;
+    }
+    const std::string dir = kCgroupRoot + path;
+    for (const int member : pids) killer.adopt(member);
+
+    // cgroup.kill (Linux 5.14+) SIGKILLs the whole subtree in one write,
+    // including processes forked while it runs.
+    auto cgroupKill = [&]() {
+        const int e = writeSmallFile(dir + "/cgroup.kill", "1");
+        if (e == EACCES) result.error = EPERM;
+        return e == 0;
+    };
+
+    if (opts.sig == SIGKILL && cgroupKill()) {
+        result.cgroupKilled = true;
+        result.converged = true;
+    } else if (result.error == 0) {
+        result.converged = killer.signalCgroup(dir, opts.sig, deadlineAfter(opts.freezeTimeoutMs));
+        if (killer.cancelled() && !result.converged) result.error = ECANCELED;
+    }
+    result.signalled = result.members.size();
+    if (result.error != 0) return result;
+
+    result.survivors = waitForExits(result, opts);
+    if (result.survivors == 0 || opts.sig == SIGKILL || opts.graceMs <= 0) return result;
+
+    if (cgroupKill()) {
+        result.cgroupKilled = true;
+    } else if (!killer.signalCgroup(dir, SIGKILL, deadlineAfter(opts.freezeTimeoutMs))) {
+        result.converged = false;
+    }
+    result.signalled = result.members.size();
+    result.survivors = waitAllExit(result.members, kKillWaitMs);
+    return result;
+}
+
+} // namespace FrogKill
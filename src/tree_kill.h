@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "proc_kill.h"
+
+namespace FrogKill {
+
+// Fork-bomb-resistant tree kill, shared by the GUI and frogkill-helper
+// (Qt-free).
+//
+// A tree is first frozen so that no member can fork while it is being
+// signalled:
+//  - with the cgroup v2 freezer, when the tree owns its cgroup (every
+//    process in it belongs to the tree): new children are born frozen;
+//  - otherwise by a SIGSTOP sweep, repeated until a pass finds no new
+//    descendant and every member is stopped.
+// The final signal then goes to the frozen set, followed by SIGCONT (so
+// SIGTERM can be delivered), and the exits are verified. All phases share
+// one deadline, so a tight fork loop cannot keep the sweep running. The
+// calling process is never stopped or signalled, even inside the tree.
+
+struct TreeKillOptions {
+    int sig{0};                 // SIGTERM or SIGKILL
+    // How long to wait for the exits before escalating SIGTERM -> SIGKILL
+    // (same meaning as in terminateAll()); 0 = signal and return.
+    int graceMs{0};
+    // Upper bound for freezing (the sweep gives up and kills what it has).
+    int freezeTimeoutMs{2000};
+    bool allowCgroupFreeze{true};
+    // Checked between sweep passes: once set, the tree is resumed and
+    // nothing gets the final signal (error ECANCELED).
+    const std::atomic<bool>* cancel{nullptr};
+};
+
+struct TreeKillResult {
+    int error{0};               // first errno other than ESRCH (0 = none)
+    size_t signalled{0};        // members that got the final signal
+    size_t survivors{0};        // still running when we stopped waiting
+    bool cgroupFrozen{false};   // the cgroup freezer was used
+    bool converged{false};      // freeze reached a fixpoint before the deadline
+    bool cgroupKilled{false};   // a single cgroup.kill write did the killing
+    // Handles of all members, bound to their generations (for watching).
+    std::vector<ProcHandle> members;
+};
+
+// Kills `root` (which must still be the generation started at `rootStart`;
+// 0 = don't check) and all its descendants. Blocks for up to
+// freezeTimeoutMs, plus the grace period and escalation when graceMs > 0.
+TreeKillResult killTree(int root, unsigned long long rootStart, const TreeKillOptions& opts);
+
+// Kills every process in the cgroup of `pid` (generation `startTime`) and
+// in the cgroups below it, including members that left the PPID tree
+// (double forks, daemons reparented to init). SIGKILL is one cgroup.kill
+// write (Linux 5.14+); otherwise the cgroup is frozen, every member is
+// signalled and it is thawed again (signal passes without a freezer).
+// `path` receives the cgroup. error is EOPNOTSUPP without cgroup v2, and
+// the checkCgroupTarget() errno for a refused cgroup.
+TreeKillResult killCgroup(int pid, unsigned long long startTime, const TreeKillOptions& opts, std::string& path);
+
+// cgroup v2 path of `pid` (e.g. "/user.slice/.../app.scope"). False on
+// cgroup v1/hybrid systems or if the process is gone.
+bool cgroupOf(int pid, std::string& path);
+
+// PIDs in the cgroup `path` and its descendant cgroups.
+bool cgroupMembers(const std::string& path, std::vector<int>& out);
+
+// 0 if `path` may be killed as a whole: EINVAL for the root cgroup or one
+// holding PID 1, EDEADLK if it holds the calling process, ENOENT if it is
+// gone. `members` (optional) receives cgroupMembers().
+int checkCgroupTarget(const std::string& path, std::vector<int>* members = nullptr);
+
+} // namespace FrogKill
@@ -1,24 +1,135 @@
 #include "util.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 #include <pwd.h>
+#include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
 namespace FrogKill::Util {
 
 QString trimmed(QString s) {
     s = s.trimmed();
-    // collapse excessive spaces
-    while (s.contains("  ")) s.replace("  ", " ");
+    // collapse excessive spaces (single linear pass)
+    qsizetype w = 0;
+    for (qsizetype r = 0; r < s.size(); ++r) {
+        const QChar ch = s.at(r);
+        if (ch == u' ' && w > 0 && s.at(w - 1) == u' ') continue;
+        s[w++] = ch;
+    }
+    s.truncate(w);
     return s;
 }
 
-QString usernameFromUid(uid_t uid) {
+namespace {
+
+// How often /etc/passwd is stat()ed, and how long an unknown UID is
+// remembered before NSS is asked again (LDAP/SSSD users may show up late).
+constexpr long long kPasswdCheckNs = 2'000'000'000LL;
+constexpr long long kNegativeTtlNs = 30'000'000'000LL;
+
+long long coarseNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (long long)ts.tv_sec * 1'000'000'000LL + ts.tv_nsec;
+}
+
+struct UserCache {
+    struct Entry {
+        QString name;
+        QByteArray utf8;
+        long long expiresNs{0};   // 0 = never (resolved name)
+    };
+
+    std::shared_mutex mutex;
+    std::unordered_map<uid_t, Entry> byUid;
+    struct timespec passwdMtime{};
+
+    std::atomic<long long> nextCheckNs{0};
+    std::atomic<unsigned long long> hits{0};
+    std::atomic<unsigned long long> misses{0};
+    std::atomic<unsigned long long> negativeHits{0};
+    std::atomic<unsigned long long> invalidations{0};
+
+    void revalidate(long long now) {
+        long long due = nextCheckNs.load(std::memory_order_relaxed);
+        if (now < due) return;
+        // One caller wins the check; the others keep using the cache.
+        if (!nextCheckNs.compare_exchange_strong(due, now + kPasswdCheckNs)) return;
+
+        struct stat st;
+        if (::stat("/etc/passwd", &st) != 0) return;
+        std::unique_lock lock(mutex);
+        if (st.st_mtim.tv_sec != passwdMtime.tv_sec || st.st_mtim.tv_nsec != passwdMtime.tv_nsec) {
+            if (passwdMtime.tv_sec != 0 || passwdMtime.tv_nsec != 0) {
+                invalidations.fetch_add(1, std::memory_order_relaxed);
+            }
+            passwdMtime = st.st_mtim;
+            byUid.clear();
+        }
+    }
+};
+
+UserCache& userCache() {
+    static UserCache cache;
+    return cache;
+}
+
+UserCache::Entry lookup(uid_t uid) {
+    auto& c = userCache();
+    const long long now = coarseNowNs();
+    c.revalidate(now);
+
+    {
+        std::shared_lock lock(c.mutex);
+        auto it = c.byUid.find(uid);
+        if (it != c.byUid.end() && (it->second.expiresNs == 0 || now < it->second.expiresNs)) {
+            (it->second.expiresNs == 0 ? c.hits : c.negativeHits).fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    c.misses.fetch_add(1, std::memory_order_relaxed);
+    UserCache::Entry e;
     struct passwd pwd;
     struct passwd* result = nullptr;
     char buf[4096];
     if (getpwuid_r(uid, &pwd, buf, sizeof(buf), &result) == 0 && result && result->pw_name) {
-        return QString::fromLocal8Bit(result->pw_name);
+        e.name = QString::fromLocal8Bit(result->pw_name);
+    } else {
+        e.name = QString::number((qulonglong)uid);
+        e.expiresNs = now + kNegativeTtlNs;
     }
-    return QString::number((qulonglong)uid);
+    e.utf8 = e.name.toUtf8();
+
+    std::unique_lock lock(c.mutex);
+    auto& slot = c.byUid[uid];
+    slot = std::move(e);
+    return slot;
+}
+
+} // namespace
+
+QString usernameFromUid(uid_t uid) {
+    return lookup(uid).name;
+}
+
+QByteArray usernameUtf8FromUid(uid_t uid) {
+    return lookup(uid).utf8;
+}
+
+UserCacheStats userCacheStats() {
+    auto& c = userCache();
+    UserCacheStats s;
+    s.hits = c.hits.load(std::memory_order_relaxed);
+    s.misses = c.misses.load(std::memory_order_relaxed);
+    s.negativeHits = c.negativeHits.load(std::memory_order_relaxed);
+    s.invalidations = c.invalidations.load(std::memory_order_relaxed);
+    return s;
 }
 
 } // namespace FrogKill::Util
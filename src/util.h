@@ -1,10 +1,26 @@
 #pragma once
+#include <QByteArray>
 #include <QString>
 #include <sys/types.h>
 
 namespace FrogKill::Util {
 
 QString trimmed(QString s);
+
+// Cached, process-wide and thread-safe. Returns a shared (implicitly
+// shared, never re-allocated) name for known UIDs; unknown UIDs resolve to
+// the number and are retried after a short TTL. The cache is dropped when
+// /etc/passwd changes.
 QString usernameFromUid(uid_t uid);
+// Same cache, UTF-8 encoded (for the columnar process table).
+QByteArray usernameUtf8FromUid(uid_t uid);
+
+struct UserCacheStats {
+    unsigned long long hits{0};
+    unsigned long long misses{0};          // NSS lookups performed
+    unsigned long long negativeHits{0};    // served from the unknown-UID cache
+    unsigned long long invalidations{0};   // /etc/passwd changed
+};
+UserCacheStats userCacheStats();
 
 } // namespace FrogKill::Util
@@ -0,0 +1,82 @@
+#include "worker_pool.h"
+
+#include <time.h>
+
+namespace FrogKill {
+
+static unsigned long long threadCpuNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+WorkerPool::WorkerPool(int threads) {
+    if (threads < 1) threads = 1;
+    m_threads.reserve((size_t)threads - 1);
+    for (int i = 1; i < threads; ++i) {
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+}
+
+void WorkerPool::drain(int worker) {
+    for (;;) {
+        const int task = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (task >= m_tasks) break;
+        (*m_fn)(task, worker);
+    }
+}
+
+void WorkerPool::run(int tasks, const std::function<void(int task, int worker)>& fn) {
+    if (tasks <= 0) return;
+    if (m_threads.empty() || tasks == 1) {
+        for (int t = 0; t < tasks; ++t) fn(t, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_tasks = tasks;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = (int)m_threads.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_fn = nullptr;
+}
+
+void WorkerPool::workerLoop(int worker) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        const unsigned long long cpu0 = threadCpuNs();
+        drain(worker);
+        const unsigned long long cpu = threadCpuNs() - cpu0;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workerCpuNs += cpu;
+        if (--m_busy == 0) m_done.notify_one();
+    }
+}
+
+} // namespace FrogKill
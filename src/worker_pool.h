@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FrogKill {
+
+// Fixed-size pool for fork/join style work (e.g. sharded /proc scans).
+// The calling thread participates as worker 0, so a pool of N threads
+// spawns N-1 background threads.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return (int)m_threads.size() + 1; }
+
+    // CPU time the background threads have spent on tasks so far (the
+    // caller's share is on its own thread clock). Read it from the thread
+    // that calls run().
+    unsigned long long workerCpuNs() const { return m_workerCpuNs; }
+
+    // Runs fn(task, worker) for every task in [0, tasks) and blocks until all
+    // are done. `worker` is in [0, size()) and is stable for the duration of
+    // one call, so it can index per-thread buffers.
+    void run(int tasks, const std::function<void(int task, int worker)>& fn);
+
+private:
+    void workerLoop(int worker);
+    void drain(int worker);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(int, int)>* m_fn{nullptr};
+    int m_tasks{0};
+    std::atomic<int> m_next{0};
+    int m_busy{0};
+    unsigned m_generation{0};
+    bool m_stop{false};
+    unsigned long long m_workerCpuNs{0};
+};
+
+} // namespace FrogKill